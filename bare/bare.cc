@@ -1,4 +1,13 @@
+// The inputs are generated from puzzles/ by the Makefile.
 #include "1.h"
+#include "2.h"
+#include "3.h"
+#include "7.h"
+#include "8.h"
+#include "11.h"
+#include "12.h"
+#include "16.h"
+#include "22.h"
 
 // Since we aren't including anything, we need some type aliases. Naturally,
 // these are only correct for some platforms, my own included.
@@ -12,14 +21,20 @@ extern "C" ssize_t write(int fd, const void* buffer, size_t count);
 constexpr bool IsWhitespace(char c) { return c == ' ' || c == '\n'; }
 constexpr bool IsDigit(char c) { return '0' <= c && c <= '9'; }
 
+struct Word {
+  const char* data = nullptr;
+  size_t size = 0;
+};
+
 class Reader {
  public:
   constexpr Reader(const char* begin, const char* end)
       : begin_(begin), position_(begin), end_(end) {}
 
+  // The terminating null character is not part of the input.
   template <size_t size>
   constexpr Reader(const char (&data)[size])
-      : begin_(data), position_(data), end_(data + size) {}
+      : begin_(data), position_(data), end_(data + size - 1) {}
 
   constexpr bool empty() const { return position_ == end_; }
 
@@ -45,6 +60,37 @@ class Reader {
     return true;
   }
 
+  // Skips over anything which isn't part of a number, then reads one.
+  constexpr bool FindInt(int* value) {
+    while (position_ != end_ && !IsDigit(*position_) &&
+           !(*position_ == '-' && position_ + 1 != end_ &&
+             IsDigit(position_[1]))) {
+      position_++;
+    }
+    return ReadInt(value);
+  }
+
+  // Reads a run of non-whitespace characters.
+  constexpr bool ReadWord(Word* word) {
+    SkipWhitespace();
+    if (position_ == end_) return false;
+    word->data = position_;
+    while (position_ != end_ && !IsWhitespace(*position_)) position_++;
+    word->size = position_ - word->data;
+    return true;
+  }
+
+  // Reads the literal if it comes next.
+  constexpr bool Consume(const char* literal) {
+    SkipWhitespace();
+    const char* position = position_;
+    for (; *literal; literal++, position++) {
+      if (position == end_ || *position != *literal) return false;
+    }
+    position_ = position;
+    return true;
+  }
+
  private:
   const char* begin_;
   const char* position_;
@@ -71,18 +117,18 @@ class Writer {
     return true;
   }
 
-  constexpr bool WriteInt(int value) {
+  constexpr bool WriteInt(long long value) {
     // Build the number backwards in a temporary buffer, since we want to start
     // with the least significant digit.
     bool negative = value < 0;
     if (negative) value = -value;
-    char temp[16] = {};
-    int i = 16;
-    while (value != 0) {
+    char temp[24] = {};
+    int i = 24;
+    do {
       temp[--i] = (value % 10) + '0';
       value /= 10;
-    }
-    int length = 16 - i;
+    } while (value != 0);
+    int length = 24 - i;
     if (negative) length++;
     if (position_ + length > end_) return false;
     // We now know the number fits.
@@ -90,7 +136,7 @@ class Writer {
       *position_ = '-';
       position_++;
     }
-    while (i < 16) {
+    while (i < 24) {
       *position_ = temp[i];
       position_++;
       i++;
@@ -107,13 +153,561 @@ class Writer {
   char* end_;
 };
 
+// Answers which aren't numbers. The buffer starts zeroed, so it is always
+// null-terminated as long as it isn't filled completely.
+struct Text {
+  char data[64] = {};
+};
+
 constexpr int Solve1A() {
-  Reader reader(kPuzzleInput);
+  Reader reader(kPuzzle1);
   int x = 0, total = 0;
   while (reader.ReadInt(&x)) total += x;
   return total;
 }
 
+constexpr int Solve2A() {
+  Reader reader(kPuzzle2);
+  int count_with_two = 0, count_with_three = 0;
+  for (Word box_id; reader.ReadWord(&box_id);) {
+    int counts_per_letter[26] = {};
+    for (size_t i = 0; i < box_id.size; i++) {
+      counts_per_letter[box_id.data[i] - 'a']++;
+    }
+    bool has_two = false, has_three = false;
+    for (int count : counts_per_letter) {
+      if (count == 2) has_two = true;
+      if (count == 3) has_three = true;
+    }
+    if (has_two) count_with_two++;
+    if (has_three) count_with_three++;
+  }
+  return count_with_two * count_with_three;
+}
+
+constexpr Text Solve2B() {
+  constexpr size_t kMaxBoxIds = 512;
+  Word box_ids[kMaxBoxIds] = {};
+  size_t num_box_ids = 0;
+  Reader reader(kPuzzle2);
+  while (num_box_ids < kMaxBoxIds && reader.ReadWord(&box_ids[num_box_ids])) {
+    num_box_ids++;
+  }
+  for (size_t i = 0; i < num_box_ids; i++) {
+    for (size_t j = i + 1; j < num_box_ids; j++) {
+      const Word& a = box_ids[i];
+      const Word& b = box_ids[j];
+      if (a.size != b.size) continue;
+      int num_differing_letters = 0;
+      for (size_t k = 0; k < a.size; k++) {
+        if (a.data[k] != b.data[k]) num_differing_letters++;
+      }
+      if (num_differing_letters != 1) continue;
+      Text result;
+      size_t length = 0;
+      for (size_t k = 0; k < a.size; k++) {
+        if (a.data[k] == b.data[k]) result.data[length++] = a.data[k];
+      }
+      return result;
+    }
+  }
+  return Text{};
+}
+
+namespace day3 {
+
+struct Claim {
+  int id = 0, x = 0, y = 0, width = 0, height = 0;
+};
+
+constexpr int kMaxClaims = 2048;
+constexpr int kFabricSize = 1000;
+
+}  // namespace day3
+
+constexpr int Solve3A() {
+  using namespace day3;
+  Claim claims[kMaxClaims] = {};
+  int num_claims = 0;
+  // #1 @ 1,3: 4x4
+  Reader reader(kPuzzle3);
+  while (num_claims < kMaxClaims) {
+    Claim& claim = claims[num_claims];
+    if (!reader.FindInt(&claim.id)) break;
+    reader.FindInt(&claim.x);
+    reader.FindInt(&claim.y);
+    reader.FindInt(&claim.width);
+    reader.FindInt(&claim.height);
+    num_claims++;
+  }
+  // The fabric is handled one row at a time, since a million-element array is
+  // very slow for the compiler to evaluate.
+  int overlapping = 0;
+  for (int y = 0; y < kFabricSize; y++) {
+    char row[kFabricSize] = {};
+    for (int i = 0; i < num_claims; i++) {
+      const Claim& claim = claims[i];
+      if (y < claim.y || claim.y + claim.height <= y) continue;
+      for (int x = claim.x; x < claim.x + claim.width; x++) {
+        if (row[x] < 2) row[x]++;
+      }
+    }
+    for (char cell : row) {
+      if (cell > 1) overlapping++;
+    }
+  }
+  return overlapping;
+}
+
+namespace day7 {
+
+// depends[x][y] is true if x depends on y.
+struct Dependencies {
+  bool depends[26][26] = {};
+};
+
+constexpr Dependencies GetDependencies() {
+  Dependencies dependencies;
+  Reader reader(kPuzzle7);
+  // Step C must be finished before step A can begin.
+  // 0    1 2    3  4        5      6    7 8   9
+  Word words[10] = {};
+  while (true) {
+    for (Word& word : words) {
+      if (!reader.ReadWord(&word)) return dependencies;
+    }
+    dependencies.depends[words[7].data[0] - 'A'][words[1].data[0] - 'A'] = true;
+  }
+}
+
+constexpr bool IsReady(const Dependencies& dependencies, int step) {
+  for (bool depends : dependencies.depends[step]) {
+    if (depends) return false;
+  }
+  return true;
+}
+
+constexpr void Finish(Dependencies& dependencies, int step) {
+  for (auto& target : dependencies.depends) target[step] = false;
+}
+
+}  // namespace day7
+
+constexpr Text Solve7A() {
+  using namespace day7;
+  Dependencies dependencies = GetDependencies();
+  bool done[26] = {};
+  Text order;
+  for (int length = 0; length < 26; length++) {
+    int step = 0;
+    while (step < 26 && (done[step] || !IsReady(dependencies, step))) step++;
+    if (step == 26) break;
+    done[step] = true;
+    order.data[length] = 'A' + step;
+    Finish(dependencies, step);
+  }
+  return order;
+}
+
+constexpr int Solve7B() {
+  using namespace day7;
+  constexpr int kNumWorkers = 1 + 4;  // You and four elves.
+  Dependencies dependencies = GetDependencies();
+  bool started[26] = {};
+  // The time at which each step that is in progress will finish, or -1.
+  int finish_time[26] = {};
+  for (int& time : finish_time) time = -1;
+  int num_busy = 0, time = 0;
+  while (true) {
+    for (int i = 0; i < 26 && num_busy < kNumWorkers; i++) {
+      if (!started[i] && IsReady(dependencies, i)) {
+        started[i] = true;
+        finish_time[i] = time + 61 + i;
+        num_busy++;
+      }
+    }
+    if (num_busy == 0) break;  // No further progress is possible.
+    int next_time = -1;
+    for (int t : finish_time) {
+      if (t != -1 && (next_time == -1 || t < next_time)) next_time = t;
+    }
+    time = next_time;
+    for (int i = 0; i < 26; i++) {
+      if (finish_time[i] != time) continue;
+      Finish(dependencies, i);
+      finish_time[i] = -1;
+      num_busy--;
+    }
+  }
+  return time;
+}
+
+namespace day8 {
+
+struct Node {
+  int sum = 0, value = 0;
+};
+
+// Reads a node along with all of its children and works out both answers for
+// it, so the tree never needs to be stored.
+constexpr Node ReadNode(Reader& reader) {
+  constexpr int kMaxChildren = 16;
+  int num_children = 0, num_metadata_entries = 0;
+  reader.ReadInt(&num_children);
+  reader.ReadInt(&num_metadata_entries);
+  int child_values[kMaxChildren] = {};
+  Node node;
+  for (int i = 0; i < num_children; i++) {
+    Node child = ReadNode(reader);
+    node.sum += child.sum;
+    if (i < kMaxChildren) child_values[i] = child.value;
+  }
+  for (int i = 0; i < num_metadata_entries; i++) {
+    int entry = 0;
+    reader.ReadInt(&entry);
+    node.sum += entry;
+    if (num_children == 0) {
+      node.value += entry;
+    } else if (1 <= entry && entry <= num_children && entry <= kMaxChildren) {
+      node.value += child_values[entry - 1];
+    }
+  }
+  return node;
+}
+
+}  // namespace day8
+
+constexpr int Solve8A() {
+  Reader reader(kPuzzle8);
+  return day8::ReadNode(reader).sum;
+}
+
+constexpr int Solve8B() {
+  Reader reader(kPuzzle8);
+  return day8::ReadNode(reader).value;
+}
+
+namespace day11 {
+
+constexpr int Power(int x, int y, int serial_number) {
+  int rack_id = x + 10;
+  int power = rack_id * y;
+  power += serial_number;
+  power *= rack_id;
+  power = power / 100 % 10;
+  power -= 5;
+  return power;
+}
+
+// sums[y][x] is the total power of the cells from [1, 1] to [x, y] inclusive.
+struct Grid {
+  constexpr int BlockPower(int x, int y, int size) const {
+    return sums[y + size - 1][x + size - 1] - sums[y + size - 1][x - 1] -
+           sums[y - 1][x + size - 1] + sums[y - 1][x - 1];
+  }
+
+  int sums[301][301] = {};
+};
+
+constexpr Grid GetGrid() {
+  Reader reader(kPuzzle11);
+  int serial_number = 0;
+  reader.ReadInt(&serial_number);
+  Grid grid;
+  for (int y = 1; y <= 300; y++) {
+    for (int x = 1; x <= 300; x++) {
+      grid.sums[y][x] = grid.sums[y - 1][x] + grid.sums[y][x - 1] -
+                        grid.sums[y - 1][x - 1] + Power(x, y, serial_number);
+    }
+  }
+  return grid;
+}
+
+}  // namespace day11
+
+constexpr Text Solve11A() {
+  const day11::Grid grid = day11::GetGrid();
+  int max_x = 1, max_y = 1;
+  int max_power = grid.BlockPower(max_x, max_y, 3);
+  for (int y = 1; y <= 298; y++) {
+    for (int x = 1; x <= 298; x++) {
+      int power = grid.BlockPower(x, y, 3);
+      if (power > max_power) {
+        max_power = power;
+        max_x = x;
+        max_y = y;
+      }
+    }
+  }
+  Text result;
+  Writer writer{result.data};
+  writer.WriteInt(max_x);
+  writer.Write(",");
+  writer.WriteInt(max_y);
+  return result;
+}
+
+constexpr Text Solve11B() {
+  const day11::Grid grid = day11::GetGrid();
+  int max_x = 1, max_y = 1, max_size = 1;
+  int max_power = grid.BlockPower(max_x, max_y, max_size);
+  for (int y = 1; y <= 300; y++) {
+    for (int x = 1; x <= 300; x++) {
+      int bound = 300 - (x > y ? x : y);
+      for (int size = 1; size <= bound; size++) {
+        int power = grid.BlockPower(x, y, size);
+        if (max_power < power) {
+          max_power = power;
+          max_x = x;
+          max_y = y;
+          max_size = size;
+        }
+      }
+    }
+  }
+  Text result;
+  Writer writer{result.data};
+  writer.WriteInt(max_x);
+  writer.Write(",");
+  writer.WriteInt(max_y);
+  writer.Write(",");
+  writer.WriteInt(max_size);
+  return result;
+}
+
+namespace day12 {
+
+// pot should be the middle of 5 pots.
+template <typename T>
+constexpr int Key(const T* pot, T plant) {
+  return (pot[-2] == plant) | (pot[-1] == plant) << 1 | (pot[0] == plant) << 2 |
+         (pot[1] == plant) << 3 | (pot[2] == plant) << 4;
+}
+
+}  // namespace day12
+
+constexpr long long Solve12A() {
+  constexpr int kGenerations = 20;
+  // Plants spread by at most two pots per generation in each direction, and
+  // each pot looks at the two pots on either side of it.
+  constexpr int kMargin = 2 * kGenerations + 2;
+  constexpr int kMaxPots = 256;
+  Reader reader(kPuzzle12);
+  // initial state: #..#.#..##......###...###
+  Word initial;
+  reader.Consume("initial state:");
+  reader.ReadWord(&initial);
+  if (initial.size + 2 * kMargin > kMaxPots) return -1;
+  // ...## => #
+  bool rules[32] = {};
+  for (Word pattern, result; reader.ReadWord(&pattern);) {
+    reader.Consume("=>");
+    reader.ReadWord(&result);
+    rules[day12::Key(pattern.data + 2, '#')] = result.data[0] == '#';
+  }
+  // Pot i is at pots[kMargin + i].
+  bool pots[kMaxPots] = {};
+  for (size_t i = 0; i < initial.size; i++) {
+    pots[kMargin + i] = initial.data[i] == '#';
+  }
+  int num_pots = initial.size + 2 * kMargin;
+  for (int generation = 0; generation < kGenerations; generation++) {
+    bool next[kMaxPots] = {};
+    for (int i = 2; i < num_pots - 2; i++) {
+      next[i] = rules[day12::Key(pots + i, true)];
+    }
+    for (int i = 0; i < num_pots; i++) pots[i] = next[i];
+  }
+  long long total = 0;
+  for (int i = 0; i < num_pots; i++) {
+    if (pots[i]) total += i - kMargin;
+  }
+  return total;
+}
+
+namespace day16 {
+
+struct Registers {
+  int r[4] = {};
+};
+
+constexpr bool operator==(const Registers& a, const Registers& b) {
+  for (int i = 0; i < 4; i++) {
+    if (a.r[i] != b.r[i]) return false;
+  }
+  return true;
+}
+
+struct Instruction {
+  int op = 0, a = 0, b = 0, c = 0;
+};
+
+// The ops are numbered in the order that the puzzle lists them, which isn't
+// the same as the codes used in the input.
+constexpr Registers Run(int op, const Instruction& instruction,
+                        Registers registers) {
+  auto& r = registers.r;
+  int a = instruction.a, b = instruction.b, c = instruction.c;
+  switch (op) {
+    case 0: r[c] = r[a] + r[b]; break;   // addr
+    case 1: r[c] = r[a] + b; break;      // addi
+    case 2: r[c] = r[a] * r[b]; break;   // mulr
+    case 3: r[c] = r[a] * b; break;      // muli
+    case 4: r[c] = r[a] & r[b]; break;   // banr
+    case 5: r[c] = r[a] & b; break;      // bani
+    case 6: r[c] = r[a] | r[b]; break;   // borr
+    case 7: r[c] = r[a] | b; break;      // bori
+    case 8: r[c] = r[a]; break;          // setr
+    case 9: r[c] = a; break;             // seti
+    case 10: r[c] = a > r[b]; break;     // gtir
+    case 11: r[c] = r[a] > b; break;     // gtri
+    case 12: r[c] = r[a] > r[b]; break;  // gtrr
+    case 13: r[c] = a == r[b]; break;    // eqir
+    case 14: r[c] = r[a] == b; break;    // eqri
+    case 15: r[c] = r[a] == r[b]; break; // eqrr
+  }
+  return registers;
+}
+
+constexpr bool ReadInstruction(Reader& reader, Instruction* instruction) {
+  return reader.FindInt(&instruction->op) && reader.FindInt(&instruction->a) &&
+         reader.FindInt(&instruction->b) && reader.FindInt(&instruction->c);
+}
+
+constexpr void ReadRegisters(Reader& reader, Registers* registers) {
+  // [0, 2, 2, 2]
+  for (int& r : registers->r) reader.FindInt(&r);
+  reader.Consume("]");
+}
+
+// Calls f(before, instruction, after) for each sample, and leaves the reader
+// at the start of the program.
+template <typename F>
+constexpr void ForEachSample(Reader& reader, F f) {
+  while (reader.Consume("Before:")) {
+    Registers before, after;
+    Instruction instruction;
+    ReadRegisters(reader, &before);
+    ReadInstruction(reader, &instruction);
+    reader.Consume("After:");
+    ReadRegisters(reader, &after);
+    f(before, instruction, after);
+  }
+}
+
+}  // namespace day16
+
+constexpr int Solve16A() {
+  using namespace day16;
+  int count = 0;
+  Reader reader(kPuzzle16);
+  ForEachSample(reader, [&](const Registers& before,
+                            const Instruction& instruction,
+                            const Registers& after) {
+    int possible_interpretations = 0;
+    for (int op = 0; op < 16; op++) {
+      if (Run(op, instruction, before) == after) possible_interpretations++;
+    }
+    if (possible_interpretations >= 3) count++;
+  });
+  return count;
+}
+
+constexpr int Solve16B() {
+  using namespace day16;
+  // possible[code][op] is false once a sample rules out code meaning op.
+  bool possible[16][16] = {};
+  for (auto& ops : possible) {
+    for (bool& x : ops) x = true;
+  }
+  Reader reader(kPuzzle16);
+  ForEachSample(reader, [&](const Registers& before,
+                            const Instruction& instruction,
+                            const Registers& after) {
+    for (int op = 0; op < 16; op++) {
+      if (!(Run(op, instruction, before) == after)) {
+        possible[instruction.op][op] = false;
+      }
+    }
+  });
+  // Repeatedly pin down a code which only has one possible op left.
+  int assignment[16] = {};
+  for (int& op : assignment) op = -1;
+  for (int round = 0; round < 16; round++) {
+    int code = 0, op = -1;
+    for (; code < 16; code++) {
+      if (assignment[code] != -1) continue;
+      int num_options = 0;
+      for (int i = 0; i < 16; i++) {
+        if (possible[code][i]) {
+          num_options++;
+          op = i;
+        }
+      }
+      if (num_options == 1) break;
+    }
+    if (code == 16) return -1;  // Ambiguous.
+    assignment[code] = op;
+    for (auto& ops : possible) ops[op] = false;
+  }
+  Registers registers;
+  for (Instruction instruction; ReadInstruction(reader, &instruction);) {
+    registers = Run(assignment[instruction.op], instruction, registers);
+  }
+  return registers.r[0];
+}
+
+constexpr int Solve22A() {
+  constexpr int kMaxWidth = 1024;
+  Reader reader(kPuzzle22);
+  int depth = 0, target_x = 0, target_y = 0;
+  // depth: 510
+  // target: 10,10
+  reader.FindInt(&depth);
+  reader.FindInt(&target_x);
+  reader.FindInt(&target_y);
+  if (target_x >= kMaxWidth) return -1;
+  // Erosion levels for one row at a time.
+  int row[kMaxWidth] = {};
+  int risk_total = 0;
+  for (int y = 0; y <= target_y; y++) {
+    for (int x = 0; x <= target_x; x++) {
+      int left = x > 0 ? row[x - 1] : 0;  // Already refreshed for this row.
+      int above = row[x];  // Not refreshed yet, so from the row above.
+      int geologic_index = 0;
+      if ((x == 0 && y == 0) || (x == target_x && y == target_y)) {
+        geologic_index = 0;
+      } else if (y == 0) {
+        geologic_index = x * 16807;
+      } else if (x == 0) {
+        geologic_index = y * 48271;
+      } else {
+        geologic_index = left * above;
+      }
+      row[x] = (geologic_index + depth) % 20183;
+      risk_total += row[x] % 3;
+    }
+  }
+  return risk_total;
+}
+
+// Each answer is a separate constant, so the compiler's limit on evaluation
+// steps applies to each solution on its own rather than to all of them at once.
+constexpr int kSolve1A = Solve1A();
+constexpr int kSolve2A = Solve2A();
+constexpr Text kSolve2B = Solve2B();
+constexpr int kSolve3A = Solve3A();
+constexpr Text kSolve7A = Solve7A();
+constexpr int kSolve7B = Solve7B();
+constexpr int kSolve8A = Solve8A();
+constexpr int kSolve8B = Solve8B();
+constexpr Text kSolve11A = Solve11A();
+constexpr Text kSolve11B = Solve11B();
+constexpr long long kSolve12A = Solve12A();
+constexpr int kSolve16A = Solve16A();
+constexpr int kSolve16B = Solve16B();
+constexpr int kSolve22A = Solve22A();
+
 // This part looks awkward. In order to guarantee that things happen at compile
 // time, we need to evaluate them in a constexpr context. By having a type like
 // this with the work in the constructor and the output in the object, we can
@@ -123,11 +717,21 @@ constexpr int Solve1A() {
 class Output {
  public:
   constexpr Output() {
-    int solution = Solve1A();
     Writer writer{output_};
-    writer.Write("Solve1A: ");
-    writer.WriteInt(solution);
-    writer.Write("\n");
+    WriteAnswer(writer, "Solve1A", kSolve1A);
+    WriteAnswer(writer, "Solve2A", kSolve2A);
+    WriteAnswer(writer, "Solve2B", kSolve2B);
+    WriteAnswer(writer, "Solve3A", kSolve3A);
+    WriteAnswer(writer, "Solve7A", kSolve7A);
+    WriteAnswer(writer, "Solve7B", kSolve7B);
+    WriteAnswer(writer, "Solve8A", kSolve8A);
+    WriteAnswer(writer, "Solve8B", kSolve8B);
+    WriteAnswer(writer, "Solve11A", kSolve11A);
+    WriteAnswer(writer, "Solve11B", kSolve11B);
+    WriteAnswer(writer, "Solve12A", kSolve12A);
+    WriteAnswer(writer, "Solve16A", kSolve16A);
+    WriteAnswer(writer, "Solve16B", kSolve16B);
+    WriteAnswer(writer, "Solve22A", kSolve22A);
     size_ = writer.size();
   }
 
@@ -135,7 +739,23 @@ class Output {
   constexpr size_t size() const { return size_; }
 
  private:
-  char output_[128] = {};
+  static constexpr void WriteAnswer(Writer& writer, const char* name,
+                                    long long answer) {
+    writer.Write(name);
+    writer.Write(": ");
+    writer.WriteInt(answer);
+    writer.Write("\n");
+  }
+
+  static constexpr void WriteAnswer(Writer& writer, const char* name,
+                                    const Text& answer) {
+    writer.Write(name);
+    writer.Write(": ");
+    writer.Write(answer.data);
+    writer.Write("\n");
+  }
+
+  char output_[1024] = {};
   size_t size_ = 0;
 };
 
@@ -1,7 +1,7 @@
 #!/bin/bash
 
 if [[ -z $1 ]] || [[ -z $2 ]]; then
-  >&2 echo "Usage: ./build.sh [debug|release] <output_name>"
+  >&2 echo "Usage: ./build.sh [debug|release|fast] <output_name>"
   exit 1
 fi
 
@@ -23,6 +23,8 @@ cp -r "$INPUT_DIR/"{puzzles,src} .
 
 # Build puzzles.h from all available puzzles in puzzles/*.txt
 cat >src/puzzles.h <<EOF
+#pragma once
+
 #include <cstdint>
 #include <string_view>
 
@@ -49,6 +51,21 @@ for puzzle in puzzles/*.txt; do
   echo "PUZZLE($puzzle_id);" >>src/puzzles.h
 done
 
+# Build a table of the puzzles, indexed by day.
+cat >>src/puzzles.h <<EOF
+
+inline const std::string_view* const kPuzzles[] = {$(
+  for day in {0..25}; do
+    if [[ -f "puzzles/$day.txt" ]]; then
+      echo "    &kPuzzle$day,"
+    else
+      echo "    nullptr,"
+    fi
+  done
+)
+};
+EOF
+
 # Compile each source file.
 CXX="clang++ -stdlib=libc++"
 if [[ ! -d /usr/include/c++/v1 ]]; then
@@ -61,9 +78,16 @@ CXXFLAGS=(
   -Wall
   -Wextra
   -pedantic
+  -pthread
 )
 LDFLAGS=()
 
+# Set TRACK_USABLE_SIZE=1 to find allocation sizes with malloc_usable_size()
+# rather than storing them in a header in front of every allocation.
+if [[ -n "$TRACK_USABLE_SIZE" ]]; then
+  CXXFLAGS+=(-DTRACK_USABLE_SIZE)
+fi
+
 if [[ "$MODE" == debug ]]; then
   CXXFLAGS+=(
     -g
@@ -82,57 +106,27 @@ else
   )
 fi
 
+# The fast build runs the solutions on the minimal runtime in src/fast instead
+# of the full driver, and links statically to avoid the dynamic loader.
+SOURCES=(src/*.cc)
+if [[ "$MODE" == fast ]]; then
+  CXXFLAGS+=(-DFAST_RUNTIME)
+  LDFLAGS+=(-static)
+  SOURCES=(src/day*.cc src/fast/*.cc)
+fi
+
 function compile {
   echo "Compiling $2"
   ${CXX} "${CXXFLAGS[@]}" -c "$1" -o "$2"
 }
 
-for day in src/day*.cc; do
-  day_id="$(basename --suffix=.cc "$day")"
-  compile "$day" "obj/$day_id.o" &
+# Each solution registers itself, so every source file is compiled the same way.
+for source in "${SOURCES[@]}"; do
+  source_id="$(basename --suffix=.cc "$source")"
+  compile "$source" "obj/$source_id.o" &
 done
 wait
 
-# Build the main file from all available solutions.
-SOLUTIONS="$(
-  for day in obj/day*.o; do
-    day_id="$(basename --suffix=.o "$day")"
-    cat "src/$day_id.cc"
-  done |
-  grep -ohP '^.*\bSolve[0-9]+[AB]\(\)'
-)"
-
-cat >> src/main.cc <<EOF
-
-#include "timing.h"
-#include "puzzles.h"
-
-#include <iostream>
-
-$(
-  echo "$SOLUTIONS" |
-  while read solution; do
-    echo "$solution;"
-  done
-)
-
-$(cat src/allocation.cc)
-
-int main() {
-  std::cout $(
-    grep -oP '\bSolve[0-9]+[AB]\b' <<< "$SOLUTIONS" |
-    sort -gk 1.6 |
-    uniq |
-    while read solution; do
-      echo "    << \"$solution: \" << Time($solution) << \"\\n\""
-    done
-  );
-  dump_allocation_stats();
-}
-EOF
-
-compile src/main.cc obj/main.o
-
 # Link the full program.
 echo "Linking $OUTPUT"
 ${CXX} "${CXXFLAGS[@]}" "${LDFLAGS[@]}" obj/*.o -o "$INPUT_DIR/$OUTPUT"
@@ -1,12 +1,395 @@
+#include "allocation.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <link.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifdef TRACK_USABLE_SIZE
+#include <malloc.h>
+#endif  // TRACK_USABLE_SIZE
+
+namespace {
+
+// Each thread keeps its own counters so that the allocator never has to write
+// to memory shared with other threads. Only the owning thread writes to them,
+// so relaxed loads and stores suffice; the atomics only make it safe for other
+// threads to read them.
+struct ThreadCounters {
+  enum State : char { kNew, kRegistered, kExited };
+
+  std::atomic<std::size_t> allocations, deallocations;
+  std::atomic<std::size_t> size_classes[kNumSizeClasses];
+  // Change in usage which has not yet been added to the global usage.
+  std::atomic<std::ptrdiff_t> pending_usage;
+  State state;
+  ThreadCounters* next;
+};
+
+// Usage is only added to the global total in chunks of this size, so the
+// global usage and peak are accurate to within this much per thread.
+constexpr std::ptrdiff_t kFlushThreshold = 64 << 10;
 
+// Counts from threads which have exited. Threads add to these with atomic
+// increments, since several may be exiting at once.
 struct {
-  std::size_t usage, peak_usage;
-  std::size_t allocations, deallocations;
-} allocation_info;
+  std::atomic<std::size_t> allocations, deallocations;
+  std::atomic<std::size_t> size_classes[kNumSizeClasses];
+} retired;
+
+std::atomic<std::ptrdiff_t> global_usage;
+std::atomic<std::size_t> peak_usage;
+
+// Guards the list of live threads.
+std::mutex threads_mutex;
+ThreadCounters* threads = nullptr;
+
+// This is constant-initialized, so it needs no guard and remains usable while
+// other thread_local objects are being destroyed.
+thread_local ThreadCounters thread_counters = {};
+
+void Add(std::atomic<std::size_t>& counter, std::size_t amount) {
+  counter.store(counter.load(std::memory_order_relaxed) + amount,
+                std::memory_order_relaxed);
+}
+
+std::size_t SizeClass(std::size_t size) {
+  if (size <= 8) return 0;
+  std::size_t bits = 64 - __builtin_clzll(size - 1);
+  return std::min<std::size_t>(bits - 3, kNumSizeClasses - 1);
+}
+
+void Retire(ThreadCounters& counters) {
+  std::lock_guard lock{threads_mutex};
+  retired.allocations += counters.allocations;
+  retired.deallocations += counters.deallocations;
+  for (std::size_t i = 0; i < kNumSizeClasses; i++)
+    retired.size_classes[i] += counters.size_classes[i];
+  global_usage += counters.pending_usage.exchange(0);
+  for (ThreadCounters** i = &threads; *i; i = &(*i)->next) {
+    if (*i == &counters) {
+      *i = counters.next;
+      break;
+    }
+  }
+  counters.state = ThreadCounters::kExited;
+}
+
+void Register(ThreadCounters& counters) {
+  {
+    std::lock_guard lock{threads_mutex};
+    counters.next = threads;
+    threads = &counters;
+    counters.state = ThreadCounters::kRegistered;
+  }
+  // Fold the counts into the retired totals when the thread exits.
+  struct ExitHook {
+    ~ExitHook() { Retire(thread_counters); }
+  };
+  thread_local ExitHook exit_hook;
+}
+
+void AddUsage(ThreadCounters& counters, std::ptrdiff_t amount) {
+  std::ptrdiff_t pending =
+      counters.pending_usage.load(std::memory_order_relaxed) + amount;
+  // Threads which aren't in the list flush immediately, or the usage would be
+  // lost.
+  std::ptrdiff_t threshold =
+      counters.state == ThreadCounters::kRegistered ? kFlushThreshold : 0;
+  if (pending >= threshold || pending <= -threshold) {
+    global_usage.fetch_add(pending, std::memory_order_relaxed);
+    pending = 0;
+  }
+  counters.pending_usage.store(pending, std::memory_order_relaxed);
+  if (amount < 0) return;
+  // Most allocations don't set a new peak, so this rarely needs to write.
+  std::ptrdiff_t usage =
+      global_usage.load(std::memory_order_relaxed) + pending;
+  std::size_t peak = peak_usage.load(std::memory_order_relaxed);
+  while (usage > static_cast<std::ptrdiff_t>(peak) &&
+         !peak_usage.compare_exchange_weak(peak, usage,
+                                           std::memory_order_relaxed)) {
+  }
+}
+
+void RecordAllocation(std::size_t requested, std::size_t size) {
+  ThreadCounters& counters = thread_counters;
+  if (counters.state == ThreadCounters::kNew) Register(counters);
+  if (counters.state == ThreadCounters::kExited) {
+    retired.allocations++;
+    retired.size_classes[SizeClass(requested)]++;
+  } else {
+    Add(counters.allocations, 1);
+    Add(counters.size_classes[SizeClass(requested)], 1);
+  }
+  AddUsage(counters, size);
+  AllocationScope::OnAllocate(size);
+}
+
+void RecordDeallocation(std::size_t size) {
+  ThreadCounters& counters = thread_counters;
+  if (counters.state == ThreadCounters::kRegistered) {
+    Add(counters.deallocations, 1);
+  } else {
+    // Memory can be freed by a thread which never allocated.
+    retired.deallocations++;
+  }
+  AddUsage(counters, -static_cast<std::ptrdiff_t>(size));
+  AllocationScope::OnDeallocate(size);
+}
+
+struct Totals {
+  std::size_t allocations = 0, deallocations = 0;
+  std::ptrdiff_t usage = 0;
+  SizeHistogram size_classes = {};
+};
+
+// Sum the counts over every thread, live or exited.
+Totals GetTotals() {
+  std::lock_guard lock{threads_mutex};
+  Totals totals;
+  totals.allocations = retired.allocations;
+  totals.deallocations = retired.deallocations;
+  totals.usage = global_usage;
+  for (std::size_t i = 0; i < kNumSizeClasses; i++)
+    totals.size_classes[i] = retired.size_classes[i];
+  for (const ThreadCounters* i = threads; i; i = i->next) {
+    totals.allocations += i->allocations.load(std::memory_order_relaxed);
+    totals.deallocations += i->deallocations.load(std::memory_order_relaxed);
+    totals.usage += i->pending_usage.load(std::memory_order_relaxed);
+    for (std::size_t j = 0; j < kNumSizeClasses; j++)
+      totals.size_classes[j] +=
+          i->size_classes[j].load(std::memory_order_relaxed);
+  }
+  return totals;
+}
+
+// Heap profiling. Each thread counts the bytes allocated since its last
+// sample, so allocations in between only pay for an addition. Samples are kept
+// in a fixed table rather than on the heap, so that taking one never
+// allocates.
+constexpr int kMaxFrames = 32;
+// SampleAllocation() and operator new are at the top of every stack.
+constexpr int kSkippedFrames = 2;
+constexpr std::size_t kMaxSites = 4096;
+
+struct Site {
+  int depth;
+  void* frames[kMaxFrames];
+  std::size_t samples;
+  // Estimated number of allocations that the samples represent.
+  double allocations;
+};
+
+// 0 when profiling is off.
+std::atomic<std::size_t> sample_interval = 0;
+thread_local std::size_t bytes_since_sample = 0;
+
+// Guards the sites and the number of dropped samples.
+std::mutex sites_mutex;
+Site sites[kMaxSites];
+// Samples whose stacks didn't fit in the table.
+std::size_t dropped_samples = 0;
+
+bool SampleDue(std::size_t size) {
+  std::size_t interval = sample_interval.load(std::memory_order_relaxed);
+  if (interval == 0) return false;
+  bytes_since_sample += size;
+  return bytes_since_sample >= interval;
+}
+
+[[gnu::noinline]] void SampleAllocation(std::size_t size) {
+  std::size_t interval = sample_interval.load(std::memory_order_relaxed);
+  if (interval == 0) return;
+  // A large allocation can cover several sample points. Each one stands for
+  // interval bytes, and for interval / size allocations of this size.
+  std::size_t samples = bytes_since_sample / interval;
+  bytes_since_sample %= interval;
+  double allocations =
+      static_cast<double>(samples) * interval / std::max<std::size_t>(size, 1);
+
+  void* frames[kMaxFrames + kSkippedFrames];
+  int depth = backtrace(frames, std::size(frames)) - kSkippedFrames;
+  if (depth <= 0) return;
+  void** stack = frames + kSkippedFrames;
+  std::uint64_t hash = 14695981039346656037u;
+  for (int i = 0; i < depth; i++) {
+    hash ^= reinterpret_cast<std::uintptr_t>(stack[i]);
+    hash *= 1099511628211u;
+  }
+
+  std::lock_guard lock{sites_mutex};
+  for (std::size_t probes = 0; probes < kMaxSites; probes++) {
+    Site& site = sites[(hash + probes) % kMaxSites];
+    if (site.depth == 0) {
+      site.depth = depth;
+      std::copy(stack, stack + depth, site.frames);
+    } else if (site.depth != depth ||
+               !std::equal(stack, stack + depth, site.frames)) {
+      continue;
+    }
+    site.samples += samples;
+    site.allocations += allocations;
+    return;
+  }
+  dropped_samples += samples;
+}
+
+// Name each return address as "function at file:line" using addr2line, with
+// one invocation for each module. Without line information, the name comes
+// from the dynamic symbol table if the address is inside a symbol, and
+// otherwise it is just the module and offset. In a stripped binary, the
+// nearest symbol is usually some unrelated function.
+std::unordered_map<void*, std::string> NameFrames(
+    const std::vector<void*>& frames) {
+  std::unordered_map<void*, std::string> names;
+  // Addresses to look up in each module, relative to the start of the module.
+  std::map<std::string, std::vector<std::pair<void*, std::uintptr_t>>> modules;
+  for (void* frame : frames) {
+    if (names.count(frame)) continue;
+    Dl_info info;
+    void* entry = nullptr;
+    if (dladdr1(frame, &info, &entry, RTLD_DL_SYMENT) == 0 ||
+        info.dli_fname == nullptr) {
+      std::ostringstream name;
+      name << frame;
+      names[frame] = name.str();
+      continue;
+    }
+    // The return address is just after the call, which may be on a later line.
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(frame) - 1;
+    std::uintptr_t offset =
+        address - reinterpret_cast<std::uintptr_t>(info.dli_saddr);
+    auto* header = static_cast<const ElfW(Ehdr)*>(info.dli_fbase);
+    if (header->e_type != ET_EXEC)
+      address -= reinterpret_cast<std::uintptr_t>(info.dli_fbase);
+    auto* symbol = static_cast<const ElfW(Sym)*>(entry);
+    std::ostringstream name;
+    if (info.dli_sname && symbol && offset < symbol->st_size) {
+      int status;
+      char* demangled =
+          abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+      name << (status == 0 ? demangled : info.dli_sname);
+      std::free(demangled);
+    } else {
+      name << info.dli_fname << "+0x" << std::hex << address;
+    }
+    names[frame] = name.str();
+    modules[info.dli_fname].emplace_back(frame, address);
+  }
+  for (const auto& [module, addresses] : modules) {
+    std::ostringstream command;
+    command << "addr2line -Cfpe '" << module << "'" << std::hex;
+    for (auto [frame, address] : addresses) command << " 0x" << address;
+    command << " 2>/dev/null";
+    FILE* pipe = popen(command.str().c_str(), "r");
+    if (pipe == nullptr) continue;
+    char line[4096];
+    for (auto [frame, address] : addresses) {
+      if (std::fgets(line, sizeof(line), pipe) == nullptr) break;
+      std::string name = line;
+      if (!name.empty() && name.back() == '\n') name.pop_back();
+      auto at = name.rfind(" at ");
+      if (at == std::string::npos || name.compare(at, 6, " at ??") == 0)
+        continue;
+      // Sources are compiled in a temporary directory, which is not worth
+      // showing.
+      auto src = name.rfind("/src/");
+      if (src != std::string::npos && at < src)
+        name.erase(at + 4, src + 1 - (at + 4));
+      names[frame] = name;
+    }
+    pclose(pipe);
+  }
+  return names;
+}
+
+}  // namespace
+
+// The innermost AllocationScope on the current thread, if any.
+thread_local AllocationScope* current_allocation_scope = nullptr;
+
+AllocationScope::AllocationScope() : parent_(current_allocation_scope) {
+  current_allocation_scope = this;
+}
+
+AllocationScope::~AllocationScope() {
+  assert(current_allocation_scope == this);
+  current_allocation_scope = parent_;
+}
+
+AllocationStats AllocationScope::stats() const {
+  AllocationStats stats;
+  stats.allocations = allocations_;
+  stats.bytes_allocated = bytes_allocated_;
+  stats.peak_usage = peak_usage_;
+  stats.leaked = usage_ > 0 ? usage_ : 0;
+  return stats;
+}
+
+UntrackedAllocations::UntrackedAllocations()
+    : scope_(current_allocation_scope) {
+  current_allocation_scope = nullptr;
+}
+
+UntrackedAllocations::~UntrackedAllocations() {
+  current_allocation_scope = scope_;
+}
+
+void AllocationScope::OnAllocate(std::size_t size) {
+  for (auto* scope = current_allocation_scope; scope; scope = scope->parent_) {
+    scope->allocations_++;
+    scope->bytes_allocated_ += size;
+    scope->usage_ += size;
+    if (scope->usage_ > scope->peak_usage_) scope->peak_usage_ = scope->usage_;
+  }
+}
+
+void AllocationScope::OnDeallocate(std::size_t size) {
+  for (auto* scope = current_allocation_scope; scope; scope = scope->parent_)
+    scope->usage_ -= size;
+}
+
+#ifdef TRACK_USABLE_SIZE
+
+// The allocator already knows the size of each block, so no header is needed
+// and the footprint is the same as without tracking. Sizes are the usable size
+// of each block, which may be larger than what was requested.
+void* operator new(std::size_t size) {
+  void* p = std::malloc(size);
+  RecordAllocation(size, malloc_usable_size(p));
+  if (SampleDue(size)) SampleAllocation(size);
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  if (p == nullptr) return;
+  RecordDeallocation(malloc_usable_size(p));
+  std::free(p);
+}
 
-struct AllocationMetadata {
+#else  // TRACK_USABLE_SIZE
+
+// The header keeps the default alignment of the block that follows it.
+struct alignas(std::max_align_t) AllocationMetadata {
   std::size_t size;
 #ifndef NDEBUG
   std::size_t checksum;
@@ -14,10 +397,8 @@ struct AllocationMetadata {
 };
 
 void* operator new(std::size_t size) {
-  allocation_info.allocations++;
-  allocation_info.usage += size;
-  if (allocation_info.usage > allocation_info.peak_usage)
-    allocation_info.peak_usage = allocation_info.usage;
+  RecordAllocation(size, size);
+  if (SampleDue(size)) SampleAllocation(size);
   void* p = std::malloc(sizeof(AllocationMetadata) + size);
   auto* metadata = reinterpret_cast<AllocationMetadata*>(p);
   metadata->size = size;
@@ -28,39 +409,147 @@ void* operator new(std::size_t size) {
 }
 
 void operator delete(void* p) noexcept {
+  if (p == nullptr) return;
   p = reinterpret_cast<char*>(p) - sizeof(AllocationMetadata);
   auto* metadata = reinterpret_cast<AllocationMetadata*>(p);
 #ifndef NDEBUG
   std::size_t checksum = reinterpret_cast<std::uintptr_t>(p) ^ metadata->size;
   assert(metadata->checksum == checksum);
 #endif  // NDEBUG
-  allocation_info.deallocations++;
-  allocation_info.usage -= metadata->size;
+  RecordDeallocation(metadata->size);
   std::free(p);
 }
 
-void print_bytes(std::size_t count) {
-  std::cout << count << "B";
-  if (count > 5000000) {
-    std::cout << " (~" << count / 1000000 << "MB)";
-  } else if (count > 5000) {
-    std::cout << " (~" << count / 1000 << "KB)";
+#endif  // TRACK_USABLE_SIZE
+
+std::ostream& operator<<(std::ostream& output, Bytes bytes) {
+  output << bytes.count << "B";
+  if (bytes.count > 5000000) {
+    output << " (~" << bytes.count / 1000000 << "MB)";
+  } else if (bytes.count > 5000) {
+    output << " (~" << bytes.count / 1000 << "KB)";
+  }
+  return output;
+}
+
+std::ostream& operator<<(std::ostream& output, const AllocationStats& stats) {
+  output << stats.allocations << " allocations, "
+         << Bytes{stats.bytes_allocated} << " allocated, peak usage "
+         << Bytes{stats.peak_usage};
+  if (stats.leaked) {
+    output << ", \x1b[31m" << Bytes{stats.leaked} << " leaked\x1b[0m";
+  }
+  return output;
+}
+
+std::ostream& operator<<(std::ostream& output,
+                         const SizeHistogram& histogram) {
+  // The class limits are all powers of two, so they have exact short names.
+  auto name = [](std::size_t size) {
+    if (size >= 1 << 20) return std::to_string(size >> 20) + "MB";
+    if (size >= 1 << 10) return std::to_string(size >> 10) + "KB";
+    return std::to_string(size) + "B";
+  };
+  std::size_t total = 0;
+  for (std::size_t count : histogram) total += count;
+  for (std::size_t i = 0; i < kNumSizeClasses; i++) {
+    if (histogram[i] == 0) continue;
+    std::size_t limit = std::size_t{8} << i;
+    std::string label = i + 1 < kNumSizeClasses ? "<= " + name(limit)
+                                                : " > " + name(limit / 2);
+    output << std::setw(9) << label << ": " << std::setw(9) << histogram[i]
+           << " " << std::string(50 * histogram[i] / total, '#') << "\n";
   }
+  return output;
 }
 
+SizeHistogram GetSizeHistogram() { return GetTotals().size_classes; }
+
 void dump_allocation_stats() {
-  auto info = allocation_info;
-  std::cout << info.allocations << " allocations, peak usage ";
-  print_bytes(info.peak_usage);
-  std::cout << ".\n";
-  if (info.usage != 0) {
-    std::cout << "\x1b[31m";
-    print_bytes(info.usage);
-    std::cout << " allocated at exit.\x1b[0m\n";
+  Totals totals = GetTotals();
+  std::cout << totals.allocations << " allocations, peak usage "
+            << Bytes{peak_usage} << ".\n";
+  if (totals.usage != 0) {
+    std::cout << "\x1b[31m" << Bytes{static_cast<std::size_t>(totals.usage)}
+              << " allocated at exit.\x1b[0m\n";
   }
-  if (info.allocations != info.deallocations) {
+  if (totals.allocations != totals.deallocations) {
     std::cout << "\x1b[31m";
-    std::cout << info.deallocations << " deallocations vs. "
-              << info.allocations << " allocations.\x1b[0m\n";
+    std::cout << totals.deallocations << " deallocations vs. "
+              << totals.allocations << " allocations.\x1b[0m\n";
+  }
+}
+
+void StartHeapProfile(std::size_t interval) { sample_interval = interval; }
+
+void PrintHeapProfile(std::ostream& output, std::size_t max_sites) {
+  // Printing allocates, which shouldn't end up in the profile.
+  std::size_t interval = sample_interval.exchange(0);
+  if (interval == 0) return;
+  std::vector<Site> profile;
+  std::size_t total_samples, dropped;
+  {
+    std::lock_guard lock{sites_mutex};
+    for (const Site& site : sites)
+      if (site.depth > 0) profile.push_back(site);
+    total_samples = dropped_samples;
+    dropped = dropped_samples;
+  }
+  for (const Site& site : profile) total_samples += site.samples;
+  output << "Heap profile: " << total_samples << " samples, one every "
+         << Bytes{interval} << " allocated.\n";
+  if (dropped > 0) {
+    output << dropped << " samples were dropped because there were too many "
+           << "allocation sites.\n";
   }
+  if (profile.empty()) return;
+
+  // Only frames in the solutions' own sources are shown, up to this many. If
+  // none of the frames can be placed in them, as in a stripped build, the
+  // innermost ones are shown instead.
+  constexpr int kShownFrames = 4;
+  auto by_bytes = [](const Site& a, const Site& b) {
+    return a.samples > b.samples;
+  };
+  auto by_allocations = [](const Site& a, const Site& b) {
+    return a.allocations > b.allocations;
+  };
+  // Only the sites which will be shown are named, since addr2line is slow.
+  std::size_t shown = std::min(max_sites, profile.size());
+  std::vector<Site> top_bytes(shown), top_allocations(shown);
+  std::partial_sort_copy(profile.begin(), profile.end(), top_bytes.begin(),
+                         top_bytes.end(), by_bytes);
+  std::partial_sort_copy(profile.begin(), profile.end(),
+                         top_allocations.begin(), top_allocations.end(),
+                         by_allocations);
+  std::vector<void*> frames;
+  for (const auto* top : {&top_bytes, &top_allocations}) {
+    for (const Site& site : *top)
+      frames.insert(frames.end(), site.frames, site.frames + site.depth);
+  }
+  auto names = NameFrames(frames);
+  auto in_sources = [&](void* frame) {
+    return names[frame].find(" at src/") != std::string::npos;
+  };
+
+  auto print = [&](std::string_view title, const std::vector<Site>& top) {
+    output << title << ":\n";
+    for (const Site& site : top) {
+      output << "  " << Bytes{site.samples * interval} << " ("
+             << std::fixed << std::setprecision(1)
+             << 100.0 * site.samples / total_samples << "%) in ~"
+             << static_cast<std::size_t>(site.allocations + 0.5)
+             << " allocations\n";
+      const bool any_in_sources =
+          std::any_of(site.frames, site.frames + site.depth, in_sources);
+      for (int i = 0, printed = 0; i < site.depth && printed < kShownFrames;
+           i++) {
+        if (any_in_sources && !in_sources(site.frames[i])) continue;
+        output << "      " << names[site.frames[i]] << "\n";
+        printed++;
+      }
+    }
+  };
+  print("Top sites by bytes", top_bytes);
+  print("Top sites by allocations", top_allocations);
 }
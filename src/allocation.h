@@ -0,0 +1,104 @@
+// Allocation tracking. allocation.cc replaces the global operator new and
+// operator delete so that every allocation is counted. The process-wide totals
+// are kept per thread and only summed when they are read, by
+// dump_allocation_stats() or GetSizeHistogram(). An AllocationScope attributes
+// the allocations made by the current thread during its lifetime:
+//
+// AllocationScope scope;
+// auto answer = Solve9B();
+// AllocationStats stats = scope.stats();
+//
+// The allocator can also sample allocations for a heap profile, recording the
+// call stack at every Nth byte allocated. Samples are aggregated by stack and
+// the top allocation sites are printed on request:
+//
+// StartHeapProfile(64 << 10);
+// ...
+// PrintHeapProfile(std::cout);
+//
+// By default the size of each allocation is stored in a header in front of it.
+// Building with -DTRACK_USABLE_SIZE asks malloc_usable_size() instead, so that
+// tracking doesn't change the memory footprint being measured.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iosfwd>
+
+struct AllocationStats {
+  std::size_t allocations = 0;
+  // Total number of bytes requested over all allocations.
+  std::size_t bytes_allocated = 0;
+  // Peak number of bytes live at once, relative to the start of the scope.
+  std::size_t peak_usage = 0;
+  // Bytes allocated within the scope which are still live.
+  std::size_t leaked = 0;
+};
+
+// Wrapper for printing a number of bytes with an approximate size.
+struct Bytes {
+  std::size_t count;
+};
+
+std::ostream& operator<<(std::ostream& output, Bytes bytes);
+std::ostream& operator<<(std::ostream& output, const AllocationStats& stats);
+
+// Number of allocations by requested size: [0, 8], (8, 16], (16, 32] and so
+// on, with everything over 4MB in the last class.
+constexpr std::size_t kNumSizeClasses = 21;
+using SizeHistogram = std::array<std::size_t, kNumSizeClasses>;
+
+// Prints one line per non-empty size class.
+std::ostream& operator<<(std::ostream& output, const SizeHistogram& histogram);
+
+// The histogram of every allocation made so far, on any thread.
+SizeHistogram GetSizeHistogram();
+
+class AllocationScope {
+ public:
+  AllocationScope();
+  ~AllocationScope();
+
+  AllocationScope(const AllocationScope&) = delete;
+  AllocationScope& operator=(const AllocationScope&) = delete;
+
+  AllocationStats stats() const;
+
+  // Called by the allocator for every allocation on this thread.
+  static void OnAllocate(std::size_t size);
+  static void OnDeallocate(std::size_t size);
+
+ private:
+  // Scopes can be nested, in which case allocations count towards all of them.
+  AllocationScope* parent_;
+  std::size_t allocations_ = 0, bytes_allocated_ = 0;
+  // Memory can be freed on a different thread from where it was allocated, so
+  // the usage of a single thread can go negative.
+  std::ptrdiff_t usage_ = 0, peak_usage_ = 0;
+};
+
+// Allocations made while this is alive are not attributed to any scope. This
+// is useful for copying results out of a scope without them counting as leaks.
+class UntrackedAllocations {
+ public:
+  UntrackedAllocations();
+  ~UntrackedAllocations();
+
+  UntrackedAllocations(const UntrackedAllocations&) = delete;
+  UntrackedAllocations& operator=(const UntrackedAllocations&) = delete;
+
+ private:
+  AllocationScope* scope_;
+};
+
+void dump_allocation_stats();
+
+// Start sampling allocations on every thread, taking one sample for every
+// sample_interval bytes allocated.
+void StartHeapProfile(std::size_t sample_interval);
+
+// Print the allocation sites with the most bytes and the most allocations,
+// estimated from the samples. Frames are named with addr2line where possible,
+// so names and line numbers are only available in unstripped builds.
+void PrintHeapProfile(std::ostream& output, std::size_t max_sites = 10);
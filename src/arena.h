@@ -0,0 +1,82 @@
+// Bump allocator for scratch data which lives no longer than a single run of a
+// solution. Memory is taken from operator new in chunks which double in size,
+// handed out in order, and only returned all at once when the arena is
+// destroyed:
+//
+// int SolveNX() {
+//   Arena arena;
+//   std::pmr::vector<int> scratch{&arena};
+//   ...
+// }
+//
+// Deallocation does nothing, so this suits many small short-lived containers
+// or containers that only grow. An arena must only be used by one thread.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+class Arena : public std::pmr::memory_resource {
+ public:
+  explicit Arena(std::size_t initial_chunk_size = 64 << 10)
+      : next_chunk_size_(initial_chunk_size) {}
+
+  ~Arena() override { Release(); }
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // Frees every chunk at once. Nothing allocated from the arena may be used
+  // afterwards.
+  void Release() {
+    while (chunks_) {
+      Chunk* previous = chunks_->previous;
+      ::operator delete(chunks_);
+      chunks_ = previous;
+    }
+    current_ = end_ = 0;
+  }
+
+ private:
+  struct alignas(std::max_align_t) Chunk {
+    Chunk* previous;
+  };
+
+  static std::uintptr_t Align(std::uintptr_t p, std::size_t alignment) {
+    return (p + alignment - 1) & ~(alignment - 1);
+  }
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    std::uintptr_t p = Align(current_, alignment);
+    if (p + bytes > end_ || current_ == 0) {
+      // Oversized requests still get a chunk of their own.
+      std::size_t size = std::max(next_chunk_size_, bytes + alignment);
+      next_chunk_size_ *= 2;
+      auto* chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + size));
+      chunk->previous = chunks_;
+      chunks_ = chunk;
+      current_ = reinterpret_cast<std::uintptr_t>(chunk + 1);
+      end_ = current_ + size;
+      p = Align(current_, alignment);
+    }
+    current_ = p + bytes;
+    return reinterpret_cast<void*>(p);
+  }
+
+  // Memory is only reclaimed by Release().
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::size_t next_chunk_size_;
+  Chunk* chunks_ = nullptr;
+  // The unused part of the newest chunk.
+  std::uintptr_t current_ = 0, end_ = 0;
+};
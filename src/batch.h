@@ -0,0 +1,146 @@
+// Batch mode, for solving many inputs for the same day in a single process:
+//
+// ./solve --batch=9:inputs/        Every file in inputs/, in order of name.
+// ./solve --batch=9:inputs.txt     Every file listed in inputs.txt, one path
+//                                  per line.
+//
+// Each selected part of the day is run on every input, and the answers are
+// printed with one line per input followed by the overall throughput. With
+// --parallel or --jobs=N, the inputs are shared out between the workers.
+
+#pragma once
+
+#include "allocation.h"
+#include "mapped_file.h"
+#include "registry.h"
+#include "timing.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// The inputs in a directory or listed in a manifest. Returns nullopt if the
+// path could not be read.
+inline std::optional<std::vector<std::string>> ListInputs(
+    std::string_view path) {
+  const std::string directory{path};
+  struct stat info;
+  if (stat(directory.c_str(), &info) == -1) return std::nullopt;
+  std::vector<std::string> inputs;
+  if (S_ISDIR(info.st_mode)) {
+    DIR* entries = opendir(directory.c_str());
+    if (entries == nullptr) return std::nullopt;
+    while (const dirent* entry = readdir(entries)) {
+      std::string file = directory + "/" + entry->d_name;
+      if (stat(file.c_str(), &info) == 0 && S_ISREG(info.st_mode))
+        inputs.push_back(std::move(file));
+    }
+    closedir(entries);
+    std::sort(inputs.begin(), inputs.end());
+  } else {
+    std::ifstream manifest{directory};
+    if (!manifest) return std::nullopt;
+    for (std::string line; std::getline(manifest, line);) {
+      if (!line.empty()) inputs.push_back(std::move(line));
+    }
+  }
+  return inputs;
+}
+
+// The answers for a single input, in the same order as the solutions. Empty if
+// the input could not be loaded.
+inline std::vector<std::string> SolveInput(
+    const std::string& path, const std::vector<Solution>& solutions) {
+  std::vector<std::string> answers;
+  auto file = MappedFile::Open(path);
+  if (!file) return answers;
+  for (const Solution& solution : solutions) {
+    AllocationStats allocations;
+    answers.push_back(
+        solution.run(file->contents(), &allocations, nullptr).value);
+  }
+  return answers;
+}
+
+inline bool WriteAnswers(std::ostream& output, const std::string& path,
+                         const std::vector<Solution>& solutions,
+                         const std::vector<std::string>& answers) {
+  if (answers.empty()) {
+    output << "\x1b[31m" << path << ": could not be loaded.\x1b[0m\n";
+    return false;
+  }
+  output << path << ":";
+  for (std::size_t i = 0; i < solutions.size(); i++) {
+    output << (i == 0 ? " " : ", ") << solutions[i].name << ": "
+           << answers[i];
+  }
+  output << "\n";
+  return true;
+}
+
+// Run the solutions for one day on every input under path, using the given
+// number of worker threads, or none to run on the main thread. Returns the
+// exit status for the program.
+inline int RunBatch(int day, std::string_view path, unsigned jobs,
+                    const std::vector<Solution>& selected) {
+  std::vector<Solution> solutions;
+  std::copy_if(selected.begin(), selected.end(), std::back_inserter(solutions),
+               [day](const Solution& solution) { return solution.day == day; });
+  if (solutions.empty()) {
+    std::cerr << "No solutions were selected for day " << day << ".\n";
+    return 1;
+  }
+  auto inputs = ListInputs(path);
+  if (!inputs) {
+    std::cerr << "Could not read " << path << "\n";
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  bool ok = true;
+  if (jobs == 0) {
+    // Print each input as it finishes, so that progress is visible.
+    for (const std::string& input : *inputs) {
+      ok &= WriteAnswers(std::cout, input, solutions,
+                         SolveInput(input, solutions));
+      std::cout.flush();
+    }
+  } else {
+    // As for RunParallel(), workers claim inputs until there are none left.
+    std::vector<std::vector<std::string>> answers(inputs->size());
+    std::atomic<std::size_t> next = 0;
+    auto worker = [&] {
+      while (true) {
+        std::size_t i = next++;
+        if (i >= inputs->size()) return;
+        answers[i] = SolveInput((*inputs)[i], solutions);
+      }
+    };
+    std::vector<std::thread> workers;
+    jobs = std::min<std::size_t>(jobs, inputs->size());
+    workers.reserve(jobs);
+    for (unsigned i = 0; i < jobs; i++) workers.emplace_back(worker);
+    for (std::thread& thread : workers) thread.join();
+    for (std::size_t i = 0; i < inputs->size(); i++)
+      ok &= WriteAnswers(std::cout, (*inputs)[i], solutions, answers[i]);
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << "Solved " << inputs->size() << " inputs in "
+            << Duration{std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   elapsed)}
+            << " (" << static_cast<long long>(inputs->size() / elapsed.count())
+            << " inputs/s).\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+// On-disk cache of answers, used with --cache=DIR. Each solution has a file in
+// the directory holding the key it was solved under and its answer. The key
+// combines a hash of the puzzle input with an identifier for the build, so
+// changing either the input or the program invalidates it:
+//
+// std::string key = CacheKey(puzzle);
+// ResultCache cache{"/tmp/solve-cache"};
+// if (auto answer = cache.Lookup(solution, key)) ...
+// cache.Store(solution, key, answer);
+//
+// Hashing a large input takes a while, so the key is computed once per input
+// and shared by the lookups and stores of every solution for it. Files are
+// replaced atomically, so concurrent runs can share a directory.
+
+#pragma once
+
+#include "registry.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// 64-bit FNV-1a.
+constexpr std::uint64_t HashBytes(std::string_view bytes,
+                                  std::uint64_t hash = 14695981039346656037u) {
+  for (char c : bytes) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211u;
+  }
+  return hash;
+}
+
+// Identifies the running executable by its size and modification time, which
+// change whenever it is rebuilt. Returns 0 if the executable can't be found.
+inline std::uint64_t BuildId() {
+  static const std::uint64_t id = [] {
+    struct stat info;
+    if (stat("/proc/self/exe", &info) == -1) return std::uint64_t{0};
+    std::uint64_t values[] = {
+        static_cast<std::uint64_t>(info.st_size),
+        static_cast<std::uint64_t>(info.st_mtim.tv_sec),
+        static_cast<std::uint64_t>(info.st_mtim.tv_nsec)};
+    return HashBytes({reinterpret_cast<const char*>(values), sizeof(values)});
+  }();
+  return id;
+}
+
+// The key for the answers to a puzzle input in the current build.
+inline std::string CacheKey(std::string_view puzzle) {
+  char key[34];
+  std::snprintf(key, sizeof(key), "%016llx-%016llx",
+                static_cast<unsigned long long>(BuildId()),
+                static_cast<unsigned long long>(HashBytes(puzzle)));
+  return key;
+}
+
+class ResultCache {
+ public:
+  explicit ResultCache(std::string_view directory) : directory_(directory) {}
+
+  // Returns nullopt if there is no answer saved under the key, which is the
+  // CacheKey() of the input.
+  std::optional<std::string> Lookup(const Solution& solution,
+                                    std::string_view key) const {
+    std::ifstream file{Path(solution), std::ios::binary};
+    std::string saved_key;
+    if (!file || !std::getline(file, saved_key) || saved_key != key)
+      return std::nullopt;
+    return std::string{std::istreambuf_iterator<char>(file), {}};
+  }
+
+  // Failing to write the cache is not an error: the answer is just recomputed
+  // next time.
+  void Store(const Solution& solution, std::string_view key,
+             std::string_view answer) const {
+    static std::atomic<int> counter = 0;
+    if (mkdir(directory_.c_str(), 0755) == -1 && errno != EEXIST) return;
+    // Write to a temporary file first so that readers never see a partial one.
+    std::string path = Path(solution);
+    std::string temporary = path + "." + std::to_string(getpid()) + "." +
+                            std::to_string(counter++);
+    {
+      std::ofstream file{temporary, std::ios::binary};
+      file << key << "\n" << answer;
+      if (!file.flush()) {
+        std::remove(temporary.c_str());
+        return;
+      }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0)
+      std::remove(temporary.c_str());
+  }
+
+ private:
+  std::string Path(const Solution& solution) const {
+    return directory_ + "/" + std::string(solution.name);
+  }
+
+  const std::string directory_;
+};
@@ -0,0 +1,129 @@
+// Cycle detection, for the solutions which simulate far more generations than
+// could be run one at a time, and which skip ahead once the states repeat:
+//
+// StateHistory<std::uint64_t> history;
+// for (std::int64_t generation = 0;; generation++) {
+//   std::uint64_t fingerprint = Fingerprint(grid.begin(), grid.end());
+//   if (auto cycle = history.Record(fingerprint, generation)) {
+//     // grid is the same as it was at cycle->start.
+//     for (auto n = cycle->Equivalent(kTarget) - cycle->start; n > 0; n--)
+//       grid = Step(grid);
+//     break;
+//   }
+//   grid = Step(grid);
+// }
+//
+// StateHistory remembers when each state was first seen, so it finds a cycle
+// as soon as the first state repeats, but holds every state until then. Keying
+// it by a Fingerprint() of each state rather than the state itself keeps only
+// 8 bytes per generation, at the risk of a false match between two states with
+// the same fingerprint, which is negligible for the few thousand states of a
+// puzzle. It suits states which are expensive to compute.
+//
+// FindCycle() uses Brent's algorithm, which holds only two states at a time but
+// computes up to three times as many, and suits states which are cheap to
+// compute again. It takes the equivalence of states as a parameter, so that,
+// for example, a pattern can be the same as another up to translation.
+
+#pragma once
+
+#include "flat_hash.h"
+#include "hash.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+
+// Generation start is the first which is repeated, length generations later.
+struct Cycle {
+  std::int64_t start;
+  std::int64_t length;
+
+  // The earliest generation which is the same as generation n.
+  std::int64_t Equivalent(std::int64_t n) const {
+    return n < start ? n : start + (n - start) % length;
+  }
+
+  // The number of whole cycles from Equivalent(n) to n.
+  std::int64_t Cycles(std::int64_t n) const {
+    return n < start ? 0 : (n - start) / length;
+  }
+};
+
+template <typename Key, typename Hash = std::hash<Key>>
+class StateHistory {
+ public:
+  explicit StateHistory(std::pmr::memory_resource* resource =
+                            std::pmr::get_default_resource())
+      : first_seen_(resource) {}
+
+  // Records the state seen at generation, which must be later than any
+  // recorded before, and returns nullopt. If the state was seen before,
+  // returns the cycle from then until now instead.
+  std::optional<Cycle> Record(const Key& key, std::int64_t generation) {
+    auto [entry, inserted] = first_seen_.try_emplace(key, generation);
+    if (inserted) return std::nullopt;
+    return Cycle{entry->second, generation - entry->second};
+  }
+
+ private:
+  FlatHashMap<Key, std::int64_t, Hash> first_seen_;
+};
+
+// A well mixed 64-bit hash of a sequence of integers or enums, such as the
+// cells of a grid. It can be the key of a StateHistory with the default hash.
+template <typename Iterator>
+std::uint64_t Fingerprint(Iterator first, Iterator last) {
+  // FNV-1a over the elements, which is fast but poorly mixed. Every step is a
+  // bijection, so sequences of the same length which differ in one element
+  // always have different fingerprints.
+  std::uint64_t hash = 0xcbf29ce484222325u;
+  auto add = [&hash](std::uint64_t x) { hash = (hash ^ x) * 0x100000001b3u; };
+  using T = typename std::iterator_traits<Iterator>::value_type;
+  if constexpr (std::is_pointer_v<Iterator> && sizeof(T) == 1) {
+    // Bytes in contiguous memory are added eight at a time.
+    for (; last - first >= 8; first += 8) {
+      std::uint64_t word;
+      std::memcpy(&word, first, sizeof(word));
+      add(word);
+    }
+  }
+  for (; first != last; ++first) add(static_cast<std::uint64_t>(*first));
+  return HashMix(hash);
+}
+
+// Finds the cycle in the generations start, step(start), step(step(start)) and
+// so on with Brent's algorithm, comparing states with equal(a, b). Every state
+// must eventually repeat.
+template <typename State, typename Step, typename Equal = std::equal_to<>>
+Cycle FindCycle(const State& start, Step step, Equal equal = {}) {
+  // The hare runs ahead in stretches which double in length, and the tortoise
+  // waits at the start of each stretch until the hare catches up with it.
+  std::int64_t power = 1, length = 1;
+  State tortoise = start;
+  State hare = step(start);
+  while (!equal(tortoise, hare)) {
+    if (power == length) {
+      tortoise = hare;
+      power *= 2;
+      length = 0;
+    }
+    hare = step(hare);
+    length++;
+  }
+  // With the hare a whole cycle ahead, the two meet at the start of it.
+  tortoise = start;
+  hare = start;
+  for (std::int64_t i = 0; i < length; i++) hare = step(hare);
+  std::int64_t first = 0;
+  while (!equal(tortoise, hare)) {
+    tortoise = step(tortoise);
+    hare = step(hare);
+    first++;
+  }
+  return Cycle{first, length};
+}
@@ -1,22 +1,18 @@
-#include "puzzles.h"
+#include "flat_hash.h"
+#include "hash.h"
+#include "integers.h"
+#include "registry.h"
+#include "scanner.h"
+#include "stream.h"
 
-#include <iterator>
-#include <iostream>
 #include <numeric>
-#include <unordered_set>
-#include <sstream>
-#include <string>
+#include <string_view>
 #include <vector>
 
-int Solve1A() {
-  std::istringstream input{std::string{kPuzzle1}};
-  return reduce(std::istream_iterator<int>{input}, {});
-}
+namespace {
 
-int Solve1B() {
-  std::istringstream input{std::string{kPuzzle1}};
-  const std::vector<int> deltas{std::istream_iterator<int>{input}, {}};
-  std::unordered_set<int> seen;
+int FirstRepeatedFrequency(const std::vector<int>& deltas) {
+  FlatHashSet<int, MixedHash<int>> seen;
   // Try to find a match in the first iteration.
   int frequency = 0;
   for (int x : deltas) {
@@ -32,3 +28,33 @@ int Solve1B() {
     }
   }
 }
+
+}  // namespace
+
+int Solve1A(std::string_view puzzle) {
+  const std::vector<int> deltas = ExtractAllIntegers(puzzle);
+  return reduce(begin(deltas), end(deltas));
+}
+
+int Solve1A_Stream(LineReader& lines) {
+  int frequency = 0;
+  while (auto line = lines.Next()) frequency += Scanner{*line}.Int();
+  return frequency;
+}
+
+int Solve1B(std::string_view puzzle) {
+  return FirstRepeatedFrequency(ExtractAllIntegers(puzzle));
+}
+
+// The deltas are needed for repeated passes, so they are kept, but not the
+// text they came from.
+int Solve1B_Stream(LineReader& lines) {
+  std::vector<int> deltas;
+  while (auto line = lines.Next()) deltas.push_back(Scanner{*line}.Int());
+  return FirstRepeatedFrequency(deltas);
+}
+
+REGISTER_SOLUTION(Solve1A);
+REGISTER_STREAMING_SOLUTION(Solve1A_Stream);
+REGISTER_SOLUTION(Solve1B);
+REGISTER_STREAMING_SOLUTION(Solve1B_Stream);
@@ -1,14 +1,14 @@
-#include "puzzles.h"
+#include "registry.h"
+#include "scanner.h"
+#include "stream.h"
 
 #include "vec2.h"
 
+#include <algorithm>
 #include <cassert>
-#include <iostream>
-#include <sstream>
-#include <iterator>
-#include <string_view>
 #include <vector>
 #include <string>
+#include <string_view>
 
 using Vector = vec2<int>;
 struct Point { Vector position, velocity; };
@@ -26,29 +26,37 @@ constexpr Vector at(Point p, int time) {
   return p.position + p.velocity * time;
 }
 
-int svtoi(std::string_view input) {
-  const char* begin = input.data();
-  char* end = nullptr;
-  int result = std::strtol(begin, &end, 10);
-  assert(begin != end);
-  return result;
+// position=<-30509,  41062> velocity=< 3, -4>
+Point ParsePoint(Scanner& scanner) {
+  Point point;
+  scanner.Expect("position=<");
+  point.position.x = scanner.Int();
+  scanner.Expect(",");
+  point.position.y = scanner.Int();
+  scanner.Expect("> velocity=<");
+  point.velocity.x = scanner.Int();
+  scanner.Expect(",");
+  point.velocity.y = scanner.Int();
+  scanner.Expect(">");
+  return point;
 }
 
-std::istream& operator>>(std::istream& input, Point& point) {
-  char line_data[100];
-  if (!input.getline(line_data, 100)) return input;
-  auto number_after =
-      [i = 0, line = std::string_view{line_data}](char c) mutable {
-    auto result = line.find(c, i);
-    assert(result != std::string::npos);
-    i = result + 1;
-    return svtoi(line.substr(i));
-  };
-  point.position.x = number_after('<');
-  point.position.y = number_after(',');
-  point.velocity.x = number_after('<');
-  point.velocity.y = number_after(',');
-  return input;
+std::vector<Point> GetInput(std::string_view puzzle) {
+  std::vector<Point> points;
+  Scanner scanner{puzzle};
+  while (!scanner.done()) points.push_back(ParsePoint(scanner));
+  return points;
+}
+
+// Finding the alignment takes many passes over the points, so they are all
+// kept, but only in their parsed form.
+std::vector<Point> ReadPoints(LineReader& lines) {
+  std::vector<Point> points;
+  while (auto line = lines.Next()) {
+    Scanner scanner{*line};
+    points.push_back(ParsePoint(scanner));
+  }
+  return points;
 }
 
 BoundingBox Bounds(const std::vector<Point>& points, int time) {
@@ -97,9 +105,7 @@ int FindAlignmentTime(const std::vector<Point>& points) {
   }
 }
 
-std::string Solve10A() { 
-  std::istringstream input{std::string{kPuzzle10}};
-  const std::vector<Point> points{std::istream_iterator<Point>{input}, {}};
+std::string Render(const std::vector<Point>& points) {
   int time = FindAlignmentTime(points);
   BoundingBox bounds = Bounds(points, time);
   int width = bounds.max.x - bounds.min.x, height = bounds.max.y - bounds.min.y;
@@ -117,8 +123,23 @@ std::string Solve10A() {
   return result;
 }
 
-int Solve10B() {
-  std::istringstream input{std::string{kPuzzle10}};
-  const std::vector<Point> points{std::istream_iterator<Point>{input}, {}};
-  return FindAlignmentTime(points);
+std::string Solve10A(std::string_view puzzle) {
+  return Render(GetInput(puzzle));
 }
+
+std::string Solve10A_Stream(LineReader& lines) {
+  return Render(ReadPoints(lines));
+}
+
+int Solve10B(std::string_view puzzle) {
+  return FindAlignmentTime(GetInput(puzzle));
+}
+
+int Solve10B_Stream(LineReader& lines) {
+  return FindAlignmentTime(ReadPoints(lines));
+}
+
+REGISTER_SOLUTION(Solve10A);
+REGISTER_STREAMING_SOLUTION(Solve10A_Stream);
+REGISTER_SOLUTION(Solve10B);
+REGISTER_STREAMING_SOLUTION(Solve10B_Stream);
@@ -1,8 +1,9 @@
-#include "puzzles.h"
+#include "registry.h"
+#include "scanner.h"
 
 #include <array>
-#include <iostream>
 #include <string>
+#include <string_view>
 
 namespace {
 
@@ -47,8 +48,8 @@ class Grid {
 
 }  // namespace
 
-std::string Solve11A() {
-  const Grid grid{stoi(std::string(kPuzzle11))};
+std::string Solve11A(std::string_view puzzle) {
+  const Grid grid{Scanner{puzzle}.Int()};
   struct { int x = 1, y = 1; } max_block;
   int max_power = grid.block_power(max_block.x, max_block.y, 3);
   for (int y = 1; y <= 298; y++) {
@@ -63,8 +64,8 @@ std::string Solve11A() {
   return std::to_string(max_block.x) + "," + std::to_string(max_block.y);
 }
 
-std::string Solve11B() {
-  const Grid grid{stoi(std::string(kPuzzle11))};
+std::string Solve11B(std::string_view puzzle) {
+  const Grid grid{Scanner{puzzle}.Int()};
   struct { int x = 1, y = 1, size = 1; } max_block;
   int max_power = grid.block_power(max_block.x, max_block.y, max_block.size);
   for (int y = 1; y <= 300; y++) {
@@ -81,3 +82,6 @@ std::string Solve11B() {
   return std::to_string(max_block.x) + "," + std::to_string(max_block.y) + "," +
          std::to_string(max_block.size);
 }
+
+REGISTER_SOLUTION(Solve11A);
+REGISTER_SOLUTION(Solve11B);
@@ -1,11 +1,13 @@
-#include "puzzles.h"
+#include "cycle.h"
+#include "registry.h"
+#include "scanner.h"
 
 #include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstdint>
-#include <iostream>
 #include <numeric>
+#include <string_view>
 #include <vector>
 
 namespace {
@@ -21,7 +23,7 @@ class Rules {
   constexpr bool WillGrow(const bool* pot) const { return mapping_[key(pot)]; }
 
  private:
-  friend Input GetInput();
+  friend Input GetInput(std::string_view puzzle);
 
   // pot should be the middle of 5 pots.
   constexpr int key(const char* pot) const {
@@ -42,33 +44,23 @@ struct Input {
   Rules rules;
 };
 
-Input GetInput() {
+Input GetInput(std::string_view puzzle) {
   Input input;
-  // Load the initial space.
-  auto initial_begin = kPuzzle12.find(": ");
-  assert(initial_begin != std::string_view::npos);
-  initial_begin += 2;
-  auto initial_end = kPuzzle12.find('\n', initial_begin);
-  assert(initial_end != std::string_view::npos);
-  assert(initial_end - initial_begin == kInitialPots);
-  auto initial = kPuzzle12.substr(initial_begin, initial_end - initial_begin);
+  Scanner scanner{puzzle};
+  scanner.Expect("initial state:");
+  std::string_view initial = scanner.Word();
+  assert(initial.size() == kInitialPots);
   std::transform(begin(initial), end(initial), begin(input.pots),
                  [](char c) { return c == '#'; });
-  // Load all the growth rules.
-  auto rule_start = kPuzzle12.find("\n\n", initial_end);
-  assert(rule_start != std::string_view::npos);
-  rule_start += 2;
-  int rules_read = 0;
-  for (auto i = rule_start, n = kPuzzle12.length() - 1; i < n; i++) {
-    auto rule_end = kPuzzle12.find('\n', rule_start);
-    if (rule_end == std::string_view::npos) break;
-    std::string_view line = kPuzzle12.substr(rule_start, rule_end - rule_start);
-    assert(line.length() == 10);
-    input.rules.mapping_[input.rules.key(line.data() + 2)] = line[9] == '#';
-    rule_start = rule_end + 1;
-    rules_read++;
+  // Rules which are not listed leave the pot empty.
+  while (!scanner.done()) {
+    std::string_view pattern = scanner.Word();
+    assert(pattern.size() == 5);
+    scanner.Expect("=>");
+    char result = scanner.Char();
+    assert(result == '#' || result == '.');
+    input.rules.mapping_[input.rules.key(pattern.data() + 2)] = result == '#';
   }
-  assert(rules_read == 32);
   return input;
 }
 
@@ -103,55 +95,51 @@ class Pots {
   std::int64_t left_, right_;
 };
 
-struct ShiftResult {
-  bool is_shifted = false;
-  std::int64_t offset = 0;
-};
-
-constexpr ShiftResult kNotShifted{};
-
-ShiftResult FindShift(const Pots& a, const Pots& b) {
+// Pots are the same as others up to translation if they hold the same pattern,
+// wherever it is.
+bool SameUpToTranslation(const Pots& a, const Pots& b) {
   std::int64_t range_a = a.right() - a.left();
   std::int64_t range_b = b.right() - b.left();
-  if (range_a != range_b) return kNotShifted;
+  if (range_a != range_b) return false;
   std::int64_t offset = b.left() - a.left();
   for (std::int64_t i = a.left(); i < a.right(); i++) {
-    if (a.get(i) != b.get(i + offset)) return kNotShifted;
+    if (a.get(i) != b.get(i + offset)) return false;
   }
-  return ShiftResult{true, offset};
+  return true;
 }
 
-std::int64_t GenerationSum(std::int64_t target_generation) {
-  Input input = GetInput();
-  // Two rows of pots for double buffering. Pot i is at kExpansionBorder + i.
+// A fingerprint of the pattern, which is the same for pots which are the same
+// up to translation.
+std::uint64_t Pattern(const Pots& pots) {
+  const bool* first = &pots.get(pots.left());
+  return Fingerprint(first, first + (pots.right() - pots.left()));
+}
+
+Pots Initial(const Input& input) {
   Pots pots{-5, kInitialPots + 5};
   for (std::int64_t i = 0; i < kInitialPots; i++) pots.set(i, input.pots[i]);
-  std::int64_t generations = 0;
-  while (generations < target_generation) {
-    generations++;
-    Pots previous = std::move(pots);
-    std::int64_t begin = previous.left() - 5, end = previous.right() + 5;
-    assert(begin < end);
-    pots = Pots{begin, end};
-    for (std::int64_t i = begin + 3, n = end - 3; i < n; i++) {
-      pots.set(i, input.rules.WillGrow(&previous.get(i)));
-    }
+  return pots;
+}
 
-    if (auto [is_shifted, offset] = FindShift(previous, pots); is_shifted) {
-      // This looks the same as the previous iteration, so every subsequent
-      // iteration will look identical too aside from a shfit. We can optimize
-      // by just jumping straight to the end state.
-      std::int64_t final_offset = offset * (target_generation - generations);
-      previous = std::move(pots);
-      pots =
-          Pots{previous.left() + final_offset, previous.right() + final_offset};
-      for (std::int64_t i = previous.left(), n = previous.right(); i < n; i++) {
-        pots.set(i + final_offset, previous.get(i));
-      }
-      break;
-    }
+Pots Step(const Pots& previous, const Rules& rules) {
+  std::int64_t begin = previous.left() - 5, end = previous.right() + 5;
+  assert(begin < end);
+  Pots pots{begin, end};
+  for (std::int64_t i = begin + 3, n = end - 3; i < n; i++) {
+    pots.set(i, rules.WillGrow(&previous.get(i)));
+  }
+  return pots;
+}
+
+Pots Shift(const Pots& pots, std::int64_t offset) {
+  Pots shifted{pots.left() + offset, pots.right() + offset};
+  for (std::int64_t i = pots.left(), n = pots.right(); i < n; i++) {
+    shifted.set(i + offset, pots.get(i));
   }
-  // Sum up the pots.
+  return shifted;
+}
+
+std::int64_t Sum(const Pots& pots) {
   std::int64_t total = 0;
   for (std::int64_t i = pots.left(), n = pots.right(); i < n; i++) {
     if (pots.get(i)) total += i;
@@ -159,7 +147,65 @@ std::int64_t GenerationSum(std::int64_t target_generation) {
   return total;
 }
 
+// Once a pattern repeats, every later generation repeats too, moved along by
+// the same amount each time around the cycle, so the target generation is
+// reached by running at most one more cycle and then moving the pattern.
+std::int64_t GenerationSum(std::string_view puzzle,
+                           std::int64_t target_generation) {
+  Input input = GetInput(puzzle);
+  Pots pots = Initial(input);
+  StateHistory<std::uint64_t> history;
+  // Where the pattern starts in each generation so far.
+  std::vector<std::int64_t> lefts;
+  for (std::int64_t generation = 0; generation < target_generation;
+       generation++) {
+    if (auto cycle = history.Record(Pattern(pots), generation)) {
+      // This generation is one cycle on from cycle->start.
+      std::int64_t drift = pots.left() - lefts[cycle->start];
+      std::int64_t equivalent = cycle->Equivalent(target_generation);
+      for (std::int64_t i = cycle->start; i < equivalent; i++)
+        pots = Step(pots, input.rules);
+      return Sum(Shift(pots, drift * (cycle->Cycles(target_generation) - 1)));
+    }
+    lefts.push_back(pots.left());
+    pots = Step(pots, input.rules);
+  }
+  return Sum(pots);
+}
+
+// Pots are cheap to compute again, so Brent's algorithm only holds two
+// generations at a time, and runs through the generations again afterwards.
+std::int64_t GenerationSumBrent(std::string_view puzzle,
+                                std::int64_t target_generation) {
+  Input input = GetInput(puzzle);
+  auto step = [&](const Pots& pots) { return Step(pots, input.rules); };
+  const Pots initial = Initial(input);
+  Cycle cycle = FindCycle(initial, step, SameUpToTranslation);
+  Pots pots = initial;
+  std::int64_t equivalent = cycle.Equivalent(target_generation);
+  for (std::int64_t i = 0; i < equivalent; i++) pots = step(pots);
+  std::int64_t cycles = cycle.Cycles(target_generation);
+  if (cycles == 0) return Sum(pots);
+  Pots later = pots;
+  for (std::int64_t i = 0; i < cycle.length; i++) later = step(later);
+  std::int64_t drift = later.left() - pots.left();
+  return Sum(Shift(pots, drift * cycles));
+}
+
 }  // namespace
 
-std::int64_t Solve12A() { return GenerationSum(20); }
-std::int64_t Solve12B() { return GenerationSum(50'000'000'000); }
+std::int64_t Solve12A(std::string_view puzzle) {
+  return GenerationSum(puzzle, 20);
+}
+
+std::int64_t Solve12B(std::string_view puzzle) {
+  return GenerationSum(puzzle, 50'000'000'000);
+}
+
+std::int64_t Solve12B_Brent(std::string_view puzzle) {
+  return GenerationSumBrent(puzzle, 50'000'000'000);
+}
+
+REGISTER_SOLUTION(Solve12A);
+REGISTER_SOLUTION(Solve12B);
+REGISTER_SOLUTION(Solve12B_Brent);
@@ -1,13 +1,13 @@
-#include "puzzles.h"
+#include "grid2d.h"
+#include "registry.h"
 
 #include "vec2.h"
 
 #include <algorithm>
-#include <array>
 #include <cassert>
 #include <cstdint>
-#include <iostream>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -15,7 +15,7 @@ namespace {
 
 constexpr int kGridWidth = 150;
 constexpr int kGridHeight = 150;
-using Grid = std::array<std::array<char, kGridWidth>, kGridHeight>;
+using Grid = Grid2D<char>;
 
 enum class Direction : unsigned char { kUp, kRight, kDown, kLeft };
 enum class Choice : unsigned char { kLeft, kStraight, kRight };
@@ -60,37 +60,37 @@ constexpr bool operator==(Cart a, Cart b) {
          a.next_choice == b.next_choice;
 }
 
-Input GetInput() {
+Input GetInput(std::string_view puzzle) {
 #ifndef NDEBUG
   // Verify that the input is a 150x150 grid.
-  assert(kPuzzle13.length() == (kGridWidth + 1) * kGridHeight);
+  assert(puzzle.length() == (kGridWidth + 1) * kGridHeight);
   for (int i = 0; i < kGridHeight; i++)
-    assert(kPuzzle13[(1 + kGridWidth) * (i + 1) - 1] == '\n');
+    assert(puzzle[(1 + kGridWidth) * (i + 1) - 1] == '\n');
 #endif  // NDEBUG
-  Input input;
+  Input input{Grid{kGridWidth, kGridHeight}, {}};
   for (unsigned char y = 0; y < kGridHeight; y++) {
     int row_offset = (1 + kGridWidth) * y;
     for (unsigned char x = 0; x < kGridWidth; x++) {
-      char cell = kPuzzle13[row_offset + x];
+      char cell = puzzle[row_offset + x];
       switch (cell) {
         case '^':
           input.carts.push_back(Cart{{x, y}, Direction::kUp, Choice::kLeft});
-          input.grid[y][x] = '|';
+          input.grid(x, y) = '|';
           break;
         case '>':
           input.carts.push_back(Cart{{x, y}, Direction::kRight, Choice::kLeft});
-          input.grid[y][x] = '-';
+          input.grid(x, y) = '-';
           break;
         case 'v':
           input.carts.push_back(Cart{{x, y}, Direction::kDown, Choice::kLeft});
-          input.grid[y][x] = '|';
+          input.grid(x, y) = '|';
           break;
         case '<':
           input.carts.push_back(Cart{{x, y}, Direction::kLeft, Choice::kLeft});
-          input.grid[y][x] = '-';
+          input.grid(x, y) = '-';
           break;
         default:
-          input.grid[y][x] = cell;
+          input.grid(x, y) = cell;
       }
     }
   }
@@ -101,7 +101,7 @@ constexpr auto At(Position position) {
   return [=](Cart cart) { return cart.position == position; };
 }
 
-constexpr Cart AdvanceCart(const Grid& grid, Cart cart) {
+Cart AdvanceCart(const Grid& grid, Cart cart) {
   // Find the new position.
   switch (cart.direction) {
     case Direction::kUp:
@@ -122,7 +122,7 @@ constexpr Cart AdvanceCart(const Grid& grid, Cart cart) {
       break;
   }
   // Find the new orientation.
-  switch (grid[cart.position.y][cart.position.x]) {
+  switch (grid[cart.position]) {
     case '\\':
       switch (cart.direction) {
         case Direction::kUp: cart.direction = Direction::kLeft; break;
@@ -184,14 +184,17 @@ Position LastCartStanding(const Grid& grid, std::vector<Cart> carts) {
 
 }  // namespace
 
-std::string Solve13A() {
-  auto [grid, carts] = GetInput();
+std::string Solve13A(std::string_view puzzle) {
+  auto [grid, carts] = GetInput(puzzle);
   Position result = RunUntilCollision(grid, std::move(carts));
   return std::to_string(result.x) + "," + std::to_string(result.y);
 }
 
-std::string Solve13B() {
-  auto [grid, carts] = GetInput();
+std::string Solve13B(std::string_view puzzle) {
+  auto [grid, carts] = GetInput(puzzle);
   Position result = LastCartStanding(grid, std::move(carts));
   return std::to_string(result.x) + "," + std::to_string(result.y);
 }
+
+REGISTER_SOLUTION(Solve13A);
+REGISTER_SOLUTION(Solve13B);
@@ -1,10 +1,11 @@
-#include "puzzles.h"
+#include "registry.h"
+#include "scanner.h"
 
 #include <algorithm>
 #include <cassert>
-#include <iostream>
 #include <numeric>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace {
@@ -32,8 +33,8 @@ struct State {
 
 }  // namespace
 
-std::string Solve14A() {
-  int steps = std::stoi(std::string(kPuzzle14));
+std::string Solve14A(std::string_view puzzle) {
+  int steps = Scanner{puzzle}.Int();
   std::size_t last = steps + 10;  // Space for the 10 immediately after.
   State state;
   // Reserve space for all recipes of interest plus padding to reduce
@@ -47,9 +48,9 @@ std::string Solve14A() {
   return result;
 }
 
-std::size_t Solve14B() {
-  std::string puzzle{kPuzzle14.substr(0, kPuzzle14.length() - 1)};  // remove \n
-  for (char& c : puzzle) c -= '0';
+std::size_t Solve14B(std::string_view puzzle) {
+  std::string digits{puzzle.substr(0, puzzle.length() - 1)};  // remove \n
+  for (char& c : digits) c -= '0';
   State state;
   state.recipes.reserve(21'000'000);
   std::size_t size_before = state.recipes.size();
@@ -57,10 +58,13 @@ std::size_t Solve14B() {
     constexpr int kBatchSize = 1000;
     for (int i = 0; i < kBatchSize; i++) state.Step();
     std::size_t size_after = state.recipes.size();
-    auto first = begin(state.recipes) + size_before - puzzle.length() + 1,
+    auto first = begin(state.recipes) + size_before - digits.length() + 1,
          last = begin(state.recipes) + size_after;
-    auto i = search(first, last, begin(puzzle), end(puzzle));
+    auto i = search(first, last, begin(digits), end(digits));
     if (i != last) return i - begin(state.recipes);
     size_before = size_after;
   }
 }
+
+REGISTER_SOLUTION(Solve14A);
+REGISTER_SOLUTION(Solve14B);
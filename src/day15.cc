@@ -1,15 +1,16 @@
-#include "puzzles.h"
+#include "arena.h"
+#include "grid2d.h"
+#include "registry.h"
+#include "search.h"
 
 #include "vec2.h"
 
 #include <algorithm>
-#include <array>
 #include <cassert>
 #include <cstdint>
-#include <iostream>
 #include <map>
+#include <memory_resource>
 #include <numeric>
-#include <queue>
 #include <string_view>
 #include <utility>
 #include <vector>
@@ -22,7 +23,7 @@ constexpr int kStartingHealth = 200;
 
 enum class UnitType : char { kElf = 'E', kGoblin = 'G' };
 using Position = vec2<std::int8_t>;
-using Grid = std::array<std::array<std::int8_t, kGridWidth>, kGridHeight>;
+using Grid = Grid2D<std::int8_t>;
 
 struct Unit {
   UnitType type;
@@ -30,13 +31,23 @@ struct Unit {
   std::uint8_t health = kStartingHealth;
 };
 
+// Squares are numbered in reading order.
+struct SquareIndex {
+  std::size_t operator()(Position p) const { return p.y * kGridWidth + p.x; }
+};
+
+// Short-lived vectors are allocated from the resource given to FromInput(),
+// which must outlive the state. Units find their way with a breadth-first
+// search which takes states from a Frontier, such as FifoFrontier<Position>.
+template <typename Frontier>
 class State {
  public:
-  static State FromInput(int elf_attack_damage);
-  void Attack(const std::vector<Position>&);
+  static State FromInput(std::string_view puzzle, int elf_attack_damage,
+                         std::pmr::memory_resource* resource);
+  void Attack(const std::pmr::vector<Position>&);
   bool Move(Unit& unit);
   void Step();
-  std::vector<Position> AdjacentEnemies(Position position) const;
+  std::pmr::vector<Position> AdjacentEnemies(Position position) const;
 
   bool done() const { return done_; }
   int outcome() const;
@@ -45,10 +56,23 @@ class State {
   int num_goblins() const { return num_goblins_; }
 
  private:
+  explicit State(std::pmr::memory_resource* resource)
+      : resource_(resource),
+        grid_(kGridWidth, kGridHeight),
+        distances_(kGridWidth, kGridHeight),
+        frontier_(resource),
+        visited_(kGridWidth * kGridHeight, SquareIndex{}, resource),
+        units_(resource) {}
+
+  std::pmr::memory_resource* resource_;
   bool done_ = false;
   int rounds_ = 0;
   Grid grid_;
-  std::vector<Unit> units_;
+  // Scratch space for GetDistances(), which Move() calls twice per unit.
+  Grid distances_;
+  Frontier frontier_;
+  DenseVisited<SquareIndex> visited_;
+  std::pmr::vector<Unit> units_;
   int num_elves_ = 0;
   int num_goblins_ = 0;
   int elf_attack_damage_ = 3;
@@ -57,56 +81,49 @@ class State {
 constexpr bool operator<(Unit a, Unit b) { return a.position < b.position; }
 
 // Establish reachability of every square in the grid from a given position.
-Grid GetDistances(const Grid& grid, Position start) {
-  Grid distances = {};
-  struct Node { Position position; int distance; };
-  std::queue<Node> frontier;
-  frontier.push({start, 0});
-  while (!frontier.empty()) {
-    Node node = frontier.front();
-    frontier.pop();
-    Position p = node.position;
-    int d = node.distance + 1;
+// Squares which can't be reached are at the maximum distance.
+template <typename Frontier>
+void GetDistances(const Grid& grid, Position start, Grid& distances,
+                  Frontier& frontier, DenseVisited<SquareIndex>& visited) {
+  distances.Fill(127);
+  frontier.clear();
+  visited.clear();
+  auto expand = [&](Position p, auto push) {
     auto add = [&](std::int8_t x, std::int8_t y) {
       assert(0 <= x && x < kGridWidth);
       assert(0 <= y && y < kGridHeight);
-      if (grid[y][x] != '.') {
-        distances[y][x] = 127;
-      } else if (distances[y][x]) {
-        assert(distances[y][x] <= d);  // Some other path got there first.
-      } else {
-        distances[y][x] = d;
-        frontier.push(Node{{x, y}, d});
-      }
+      Position next{x, y};
+      if (grid[next] != '.') return;  // Not somewhere we can go.
+      if (!visited.contains(next)) push(next, 1);
     };
     add(p.x, p.y - 1);
     add(p.x, p.y + 1);
     add(p.x - 1, p.y);
     add(p.x + 1, p.y);
-  }
-  // Mark all unreached cells as max distance.
-  for (auto& row : distances) {
-    for (auto& cell : row) {
-      if (cell == 0) cell = 127;
-    }
-  }
-  distances[start.y][start.x] = 0;
-  return distances;
+  };
+  auto settle = [&](Position p, int distance) {
+    distances[p] = distance;
+    return false;
+  };
+  Search(start, frontier, visited, expand, settle);
 }
 
-State State::FromInput(int elf_attack_damage) {
+template <typename Frontier>
+State<Frontier> State<Frontier>::FromInput(
+    std::string_view puzzle, int elf_attack_damage,
+    std::pmr::memory_resource* resource) {
 #ifndef NDEBUG
-  assert(kPuzzle15.length() == (kGridWidth + 1) * kGridHeight);
+  assert(puzzle.length() == (kGridWidth + 1) * kGridHeight);
   for (int y = 0; y < kGridHeight; y++)
-    assert(kPuzzle15[(kGridWidth + 1) * y - 1] == '\n');
+    assert(puzzle[(kGridWidth + 1) * (y + 1) - 1] == '\n');
 #endif // NDEBUG
 
-  State state;
+  State state{resource};
   state.elf_attack_damage_ = elf_attack_damage;
   for (std::int8_t y = 0; y < kGridHeight; y++) {
     int offset = (kGridWidth + 1) * y;
     for (std::int8_t x = 0; x < kGridWidth; x++) {
-      char c = kPuzzle15[offset + x];
+      char c = puzzle[offset + x];
       if (c == 'G') {
         state.num_goblins_++;
         state.units_.push_back(Unit{UnitType::kGoblin, {x, y}});
@@ -116,14 +133,16 @@ State State::FromInput(int elf_attack_damage) {
       } else {
         assert(c == '#' || c == '.');
       }
-      state.grid_[y][x] = c;
+      state.grid_(x, y) = c;
     }
   }
 
   return state;
 }
 
-void State::Attack(const std::vector<Position>& adjacent_enemies) {
+template <typename Frontier>
+void State<Frontier>::Attack(
+    const std::pmr::vector<Position>& adjacent_enemies) {
   assert(!adjacent_enemies.empty());
   // Attack
   Unit* target = nullptr;
@@ -144,7 +163,7 @@ void State::Attack(const std::vector<Position>& adjacent_enemies) {
   if (target->health <= damage) {
     // Target killed.
     target->health = 0;
-    grid_[target->position.y][target->position.x] = '.';
+    grid_[target->position] = '.';
     auto& target_count =
         target->type == UnitType::kElf ? num_elves_ : num_goblins_;
     target_count--;
@@ -154,19 +173,20 @@ void State::Attack(const std::vector<Position>& adjacent_enemies) {
   }
 }
 
-bool State::Move(Unit& unit) {
+template <typename Frontier>
+bool State<Frontier>::Move(Unit& unit) {
   auto [x, y] = unit.position;
   // Pick a target location.
-  Grid distances = GetDistances(grid_, unit.position);
+  GetDistances(grid_, unit.position, distances_, frontier_, visited_);
   Position best_target = {-1, -1};
   int best_distance = 127;
   for (const auto& target : units_) {
     if (target.health == 0) continue;  // Dead.
     if (target.type == unit.type) continue;  // Same team.
     auto consider = [&](std::int8_t x, std::int8_t y) {
-      if (grid_[y][x] != '.') return;  // Not somewhere we can go.
+      if (grid_(x, y) != '.') return;  // Not somewhere we can go.
       Position p{x, y};
-      int distance = distances[y][x];
+      int distance = distances_(x, y);
       if (std::tie(distance, p) < std::tie(best_distance, best_target)) {
         best_distance = distance;
         best_target = p;
@@ -181,7 +201,7 @@ bool State::Move(Unit& unit) {
   if (best_distance == 127) return false;
   assert(best_target.x != -1 && best_target.y != -1);
   // Find the best first step to get to that location.
-  distances = GetDistances(grid_, best_target);
+  GetDistances(grid_, best_target, distances_, frontier_, visited_);
   Position next_position = {-1, -1};
   int closest = 127;
   Position candidates[] = {{x, static_cast<std::int8_t>(y - 1)},
@@ -189,8 +209,8 @@ bool State::Move(Unit& unit) {
                            {static_cast<std::int8_t>(x + 1), y},
                            {x, static_cast<std::int8_t>(y + 1)}};
   for (Position p : candidates) {
-    if (grid_[p.y][p.x] != '.') continue;  // Not somewhere we can go.
-    int distance = distances[p.y][p.x];
+    if (grid_[p] != '.') continue;  // Not somewhere we can go.
+    int distance = distances_[p];
     if (std::tie(distance, p) < std::tie(closest, next_position)) {
       closest = distance;
       next_position = p;
@@ -199,13 +219,14 @@ bool State::Move(Unit& unit) {
   if (closest == 127) return false;
   assert(next_position.x != -1 && next_position.y != -1);
   // Move to the new location.
-  grid_[y][x] = '.';
-  grid_[next_position.y][next_position.x] = static_cast<char>(unit.type);
+  grid_(x, y) = '.';
+  grid_[next_position] = static_cast<char>(unit.type);
   unit.position = next_position;
   return true;
 }
 
-void State::Step() {
+template <typename Frontier>
+void State<Frontier>::Step() {
   sort(begin(units_), end(units_));
   for (auto& unit : units_) {
     if (unit.health == 0) continue;
@@ -217,7 +238,7 @@ void State::Step() {
     assert(1 <= unit.position.x && unit.position.x < kGridWidth - 1);
     assert(1 <= unit.position.y && unit.position.y < kGridHeight - 1);
     assert(static_cast<char>(unit.type) ==
-           grid_[unit.position.y][unit.position.x]);
+           grid_[unit.position]);
     auto adjacent_enemies = AdjacentEnemies(unit.position);
     if (!adjacent_enemies.empty()) {
       Attack(adjacent_enemies);
@@ -233,31 +254,43 @@ void State::Step() {
   if (!done_) rounds_++;
 }
 
-std::vector<Position> State::AdjacentEnemies(Position position) const {
+template <typename Frontier>
+std::pmr::vector<Position> State<Frontier>::AdjacentEnemies(
+    Position position) const {
   auto [x, y] = position;
   assert(0 < x && x < kGridWidth - 1);
   assert(0 < y && y < kGridHeight - 1);
-  assert(grid_[y][x] == 'G' || grid_[y][x] == 'E');
-  char enemy = grid_[y][x] == 'E' ? 'G' : 'E';
-  std::vector<Position> positions;
+  assert(grid_(x, y) == 'G' || grid_(x, y) == 'E');
+  char enemy = grid_(x, y) == 'E' ? 'G' : 'E';
+  std::pmr::vector<Position> positions{resource_};
   positions.reserve(4);
   // Check in reading order.
   auto add = [&](std::int8_t x, std::int8_t y) { positions.push_back({x, y}); };
-  if (grid_[y - 1][x] == enemy) add(x, y - 1);
-  if (grid_[y][x - 1] == enemy) add(x - 1, y);
-  if (grid_[y][x + 1] == enemy) add(x + 1, y);
-  if (grid_[y + 1][x] == enemy) add(x, y + 1);
+  if (grid_(x, y - 1) == enemy) add(x, y - 1);
+  if (grid_(x - 1, y) == enemy) add(x - 1, y);
+  if (grid_(x + 1, y) == enemy) add(x + 1, y);
+  if (grid_(x, y + 1) == enemy) add(x, y + 1);
   return positions;
 }
 
-int State::outcome() const {
+template <typename Frontier>
+int State<Frontier>::outcome() const {
   int health = transform_reduce(begin(units_), end(units_), 0, std::plus<>(),
                                 [](Unit u) { return u.health; });
   return health * rounds_;
 }
 
-bool ElfVictoryWith(int damage) {
-  auto state = State::FromInput(damage);
+template <typename Frontier>
+int Outcome(std::string_view puzzle, int elf_attack_damage) {
+  Arena arena;
+  auto state = State<Frontier>::FromInput(puzzle, elf_attack_damage, &arena);
+  while (!state.done()) state.Step();
+  return state.outcome();
+}
+
+bool ElfVictoryWith(std::string_view puzzle, int damage) {
+  Arena arena;
+  auto state = State<FifoFrontier<Position>>::FromInput(puzzle, damage, &arena);
   int original_num_elves = state.num_elves();
   while (!state.done()) state.Step();
   return state.num_elves() == original_num_elves;
@@ -265,17 +298,27 @@ bool ElfVictoryWith(int damage) {
 
 }  // namespace
 
-int Solve15A() {
-  auto state = State::FromInput(3);
-  while (!state.done()) state.Step();
-  return state.outcome();
+int Solve15A(std::string_view puzzle) {
+  return Outcome<FifoFrontier<Position>>(puzzle, 3);
+}
+
+int Solve15A_Bucket(std::string_view puzzle) {
+  return Outcome<BucketFrontier<Position>>(puzzle, 3);
+}
+
+int Solve15A_RadixHeap(std::string_view puzzle) {
+  return Outcome<RadixHeap<Position>>(puzzle, 3);
 }
 
-int Solve15B() {
+int Solve15A_Heap(std::string_view puzzle) {
+  return Outcome<HeapFrontier<Position>>(puzzle, 3);
+}
+
+int Solve15B(std::string_view puzzle) {
   int min_damage = 4, max_damage = 200;
   while (min_damage != max_damage) {
     int damage = min_damage + (max_damage - min_damage) / 2;
-    if (ElfVictoryWith(damage)) {
+    if (ElfVictoryWith(puzzle, damage)) {
       // Elves win with this amount, so it might be the right amount.
       max_damage = damage;
     } else {
@@ -283,7 +326,11 @@ int Solve15B() {
       min_damage = damage + 1;
     }
   }
-  auto state = State::FromInput(min_damage);
-  while (!state.done()) state.Step();
-  return state.outcome();
+  return Outcome<FifoFrontier<Position>>(puzzle, min_damage);
 }
+
+REGISTER_SOLUTION(Solve15A);
+REGISTER_SOLUTION(Solve15B);
+REGISTER_SOLUTION(Solve15A_Bucket);
+REGISTER_SOLUTION(Solve15A_RadixHeap);
+REGISTER_SOLUTION(Solve15A_Heap);
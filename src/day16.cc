@@ -1,12 +1,13 @@
-#include "puzzles.h"
+#include "registry.h"
+#include "scanner.h"
 
 #include <array>
 #include <cassert>
-#include <iostream>
 #include <limits>
 #include <numeric>
 #include <optional>
 #include <set>
+#include <string_view>
 #include <vector>
 
 namespace {
@@ -71,58 +72,60 @@ Registers Run(Instruction<Op> instruction, Registers r) {
   }
 }
 
-Instruction<std::int8_t> GetInstruction(std::size_t offset) {
+Instruction<std::int8_t> GetInstruction(Scanner& scanner) {
+  // 11 3 3 3
   Instruction<std::int8_t> instruction;
-  instruction.op = strtol(kPuzzle16.data() + offset, nullptr, 10);
-  offset = kPuzzle16.find(' ', offset);
-  assert(offset != std::string_view::npos);
-  instruction.a = kPuzzle16[offset + 1] - '0';
-  assert(0 <= instruction.a && instruction.a < 4);
-  instruction.b = kPuzzle16[offset + 3] - '0';
-  assert(0 <= instruction.a && instruction.a < 4);
-  instruction.c = kPuzzle16[offset + 5] - '0';
+  instruction.op = scanner.Int<std::int8_t>();
+  assert(0 <= instruction.op && instruction.op < 16);
+  instruction.a = scanner.Int<std::int8_t>();
   assert(0 <= instruction.a && instruction.a < 4);
+  instruction.b = scanner.Int<std::int8_t>();
+  assert(0 <= instruction.b && instruction.b < 4);
+  instruction.c = scanner.Int<std::int8_t>();
+  assert(0 <= instruction.c && instruction.c < 4);
   return instruction;
 }
 
-std::vector<Sample> GetSamples() {
+Registers GetRegisters(Scanner& scanner) {
+  // [0, 2, 2, 2]
+  Registers registers;
+  scanner.Expect("[");
+  for (int i = 0; i < 4; i++) {
+    if (i > 0) scanner.Expect(",");
+    registers[i] = scanner.Int<Register>();
+    assert(0 <= registers[i] && registers[i] < 4);
+  }
+  scanner.Expect("]");
+  return registers;
+}
+
+std::vector<Sample> GetSamples(std::string_view puzzle) {
   std::vector<Sample> samples;
-  for (auto offset = kPuzzle16.find("Before: [");
-       offset != std::string_view::npos;
-       offset = kPuzzle16.find("Before: [", offset)) {
-    Sample sample = {};
-    // Read the before state.
-    for (int i = 0; i < 4; i++) {
-      sample.before[i] = kPuzzle16[offset + 9 + 3 * i] - '0';
-      assert(0 <= sample.before[i] && sample.before[i] < 4);
-    }
-    // Read the instruction.
-    offset = kPuzzle16.find('\n', offset);
-    sample.instruction = GetInstruction(offset);
-    // Read the after state.
-    offset = kPuzzle16.find("After:  [", offset);
-    assert(offset != std::string_view::npos);
-    for (int i = 0; i < 4; i++) {
-      sample.after[i] = kPuzzle16[offset + 9 + 3 * i] - '0';
-      assert(0 <= sample.after[i] && sample.after[i] < 4);
-    }
+  Scanner scanner{puzzle};
+  while (scanner.Consume("Before:")) {
+    Sample sample;
+    sample.before = GetRegisters(scanner);
+    sample.instruction = GetInstruction(scanner);
+    scanner.Expect("After:");
+    sample.after = GetRegisters(scanner);
     samples.push_back(sample);
   }
   return samples;
 }
 
-std::vector<Instruction<Op>> GetProgram(const Assignment& assignment) {
-  auto offset = kPuzzle16.find("\n\n\n\n");
+std::vector<Instruction<Op>> GetProgram(std::string_view puzzle,
+                                        const Assignment& assignment) {
+  // The program follows the samples after a gap.
+  auto offset = puzzle.find("\n\n\n\n");
   assert(offset != std::string_view::npos);
-  offset += 4;
+  Scanner scanner{puzzle.substr(offset)};
   std::vector<Instruction<Op>> program;
-  do {
-    Instruction<std::int8_t> raw_instruction = GetInstruction(offset);
+  while (!scanner.done()) {
+    Instruction<std::int8_t> raw_instruction = GetInstruction(scanner);
     program.push_back(Instruction<Op>{assignment[raw_instruction.op],
                                       raw_instruction.a, raw_instruction.b,
                                       raw_instruction.c});
-    offset = kPuzzle16.find('\n', offset + 1);
-  } while (offset != kPuzzle16.length() - 1);
+  }
   return program;
 }
 
@@ -153,9 +156,9 @@ std::set<Assignment> FindAllAssignments(const Mapping& ruled_out) {
 
 }  // namespace
 
-int Solve16A() {
+int Solve16A(std::string_view puzzle) {
   int count = 0;
-  for (const Sample& sample : GetSamples()) {
+  for (const Sample& sample : GetSamples(puzzle)) {
     int possible_interpretations = 0;
     for (int i = 0; i < 16; i++) {
       auto op = static_cast<Op>(i);
@@ -169,8 +172,8 @@ int Solve16A() {
   return count;
 }
 
-int Solve16B() {
-  auto samples = GetSamples();
+int Solve16B(std::string_view puzzle) {
+  auto samples = GetSamples(puzzle);
 
   // If we assume that operation op has code x and we subsequently see a sample
   // with code x that doesn't agree with what op should produce, we know that
@@ -194,8 +197,11 @@ int Solve16B() {
   auto assignment = *assignments.begin();
 
   Registers registers = {};
-  for (const auto& instruction : GetProgram(assignment))
+  for (const auto& instruction : GetProgram(puzzle, assignment))
     registers = Run(instruction, registers);
 
   return registers[0];
 }
+
+REGISTER_SOLUTION(Solve16A);
+REGISTER_SOLUTION(Solve16B);
@@ -1,6 +1,9 @@
 // Wrong answer: 289 (too low)
 
-#include "puzzles.h"
+#include "grid2d.h"
+#include "integers.h"
+#include "registry.h"
+#include "trace.h"
 
 #include "vec2.h"
 
@@ -8,9 +11,9 @@
 #include <cassert>
 #include <cstdint>
 #include <functional>
-#include <iostream>
 #include <numeric>
 #include <queue>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -40,23 +43,25 @@ constexpr BoundingBox operator+(BoundingBox a, BoundingBox b) {
                      std::max(a.x_max, b.x_max), std::max(a.y_max, b.y_max)};
 }
 
-std::vector<BoundingBox> GetInput() {
+std::vector<BoundingBox> GetInput(std::string_view puzzle) {
+  TraceSpan span{"GetInput"};
   std::vector<BoundingBox> input;
-  input.reserve(2500);
-  for (auto offset = kPuzzle17.find('='); offset != std::string_view::npos;
-       offset = kPuzzle17.find('=', offset + 1)) {
-    bool x_first = kPuzzle17[offset - 1] == 'x';
-    std::int16_t a_min = strtol(kPuzzle17.data() + offset + 1, nullptr, 10);
+  // x=652, y=891..904
+  const std::vector<std::int16_t> numbers =
+      ExtractAllIntegers<std::int16_t>(puzzle);
+  assert(numbers.size() % 3 == 0);
+  input.reserve(numbers.size() / 3);
+  // The numbers don't say which axis comes first, so that is read from the
+  // start of each line.
+  std::size_t line = 0;
+  for (std::size_t i = 0; i + 3 <= numbers.size(); i += 3) {
+    assert(puzzle[line] == 'x' || puzzle[line] == 'y');
+    bool x_first = puzzle[line] == 'x';
+    line = puzzle.find('\n', line) + 1;
+    std::int16_t a_min = numbers[i], a_max = a_min;
+    std::int16_t b_min = numbers[i + 1], b_max = numbers[i + 2];
     assert(0 <= a_min && a_min < 2000);
-    std::int16_t a_max = a_min;
-    offset = kPuzzle17.find('=', offset + 1);
-    assert(kPuzzle17[offset - 1] == (x_first ? 'y' : 'x'));
-    assert(offset != std::string_view::npos);
-    std::int16_t b_min = strtol(kPuzzle17.data() + offset + 1, nullptr, 10);
     assert(0 <= b_min && b_min < 2000);
-    offset = kPuzzle17.find("..", offset + 1);
-    assert(offset != std::string_view::npos);
-    std::int16_t b_max = strtol(kPuzzle17.data() + offset + 2, nullptr, 10);
     assert(0 <= b_max && b_max < 2000);
     assert(b_min <= b_max);
     if (x_first) {
@@ -68,20 +73,7 @@ std::vector<BoundingBox> GetInput() {
   return input;
 }
 
-struct Grid {
- public:
-  Grid(int width, int height)
-      : width_(width), height_(height), cells_(width * height, Cell::kSand) {}
-  Cell& operator()(int x, int y) { return cells_[y * width_ + x]; }
-  int width() const { return width_; }
-  int height() const { return height_; }
-  auto begin() { return cells_.begin(); }
-  auto end() { return cells_.end(); }
- private:
-  int width_;
-  int height_;
-  std::vector<Cell> cells_;
-};
+using Grid = Grid2D<Cell>;
 
 struct GridData {
   Grid grid;
@@ -89,12 +81,13 @@ struct GridData {
 };
 
 GridData BuildGrid(std::vector<BoundingBox> input) {
+  TraceSpan span{"BuildGrid"};
   auto bounds = reduce(begin(input), end(input), input.front());
   // We need one space either side of any clay to allow water to fall down.
   Position offset{static_cast<std::int16_t>(bounds.x_min - 1), bounds.y_min};
   int width = 3 + bounds.x_max - bounds.x_min;
   int height = 1 + bounds.y_max - bounds.y_min;
-  Grid grid{width, height};
+  Grid grid{width, height, Cell::kSand};
   for (auto& vein : input) {
     vein.x_min -= offset.x;
     vein.y_min -= offset.y;
@@ -116,6 +109,7 @@ GridData BuildGrid(std::vector<BoundingBox> input) {
 }
 
 void PerformFlow(GridData* grid_data) {
+  TraceSpan span{"PerformFlow"};
   auto& [grid, spring] = *grid_data;
   // All flows that have yet to be fully evaluated.
   std::queue<Position> flows;
@@ -179,16 +173,17 @@ void PerformFlow(GridData* grid_data) {
 
 }  // namespace
 
-int Solve17A() {
-  auto grid_data = BuildGrid(GetInput());
+int Solve17A(std::string_view puzzle) {
+  auto grid_data = BuildGrid(GetInput(puzzle));
   PerformFlow(&grid_data);
-  return count_if(std::begin(grid_data.grid), std::end(grid_data.grid),
-                  IsWaterCell);
+  return grid_data.grid.CountIf(IsWaterCell);
 }
 
-int Solve17B() {
-  auto grid_data = BuildGrid(GetInput());
+int Solve17B(std::string_view puzzle) {
+  auto grid_data = BuildGrid(GetInput(puzzle));
   PerformFlow(&grid_data);
-  return count(std::begin(grid_data.grid), std::end(grid_data.grid),
-               Cell::kWater);
+  return grid_data.grid.Count(Cell::kWater);
 }
+
+REGISTER_SOLUTION(Solve17A);
+REGISTER_SOLUTION(Solve17B);
@@ -1,10 +1,11 @@
-#include "puzzles.h"
+#include "cycle.h"
+#include "grid2d.h"
+#include "registry.h"
 
-#include <algorithm>
-#include <array>
 #include <cassert>
-#include <iostream>
-#include <vector>
+#include <cstdint>
+#include <string_view>
+#include <utility>
 
 namespace {
 
@@ -12,58 +13,55 @@ enum class Cell : char { kOpen = '.', kTrees = '|', kLumberYard = '#' };
 
 constexpr int kGridWidth = 50;
 constexpr int kGridHeight = 50;
-using Grid = std::array<std::array<Cell, kGridWidth>, kGridHeight>;
+constexpr std::int64_t kTargetGeneration = 1'000'000'000;
+// The border of open ground around the edge never counts as adjacent trees or
+// lumber yards.
+using Grid = Grid2D<Cell>;
 
-Grid GetInput() {
+Grid GetInput(std::string_view puzzle) {
 #ifndef NDEBUG
-  assert(kPuzzle18.length() == (kGridWidth + 1) * kGridHeight);
+  assert(puzzle.length() == (kGridWidth + 1) * kGridHeight);
   for (int y = 0; y < kGridHeight; y++) {
-    assert(kPuzzle18[(1 + kGridWidth) * y - 1] == '\n');
+    assert(puzzle[(1 + kGridWidth) * (y + 1) - 1] == '\n');
   }
 #endif  // NDEBUG
 
-  Grid grid;
+  Grid grid{kGridWidth, kGridHeight, Cell::kOpen, 1, Cell::kOpen};
   for (int y = 0; y < kGridHeight; y++) {
-    const char* first = kPuzzle18.data() + (1 + kGridWidth) * y;
-    const char* last = first + kGridWidth;
-    std::copy(first, last, reinterpret_cast<char*>(grid[y].data()));
+    const char* row = puzzle.data() + (1 + kGridWidth) * y;
+    for (int x = 0; x < kGridWidth; x++) grid(x, y) = Cell(row[x]);
   }
   return grid;
 }
 
-int CountAdjacent(const Grid& grid, int cx, int cy, Cell target) {
-  int count = 0;
-  // Half open bounds - min inclusive, max exclusive.
-  int x_min = std::max(0, cx - 1), x_max = std::min(kGridWidth, cx + 2);
-  int y_min = std::max(0, cy - 1), y_max = std::min(kGridHeight, cy + 2);
-  for (int y = y_min; y < y_max; y++) {
-    for (int x = x_min; x < x_max; x++) {
-      if (x == cx && y == cy) continue;
-      if (grid[y][x] == target) count++;
-    }
+struct Adjacent {
+  int trees = 0;
+  int lumber_yards = 0;
+};
+
+Adjacent CountAdjacent(const Grid& grid, int x, int y) {
+  Adjacent adjacent;
+  for (Cell cell : grid.Neighbours8(x, y)) {
+    adjacent.trees += cell == Cell::kTrees;
+    adjacent.lumber_yards += cell == Cell::kLumberYard;
   }
-  return count;
+  return adjacent;
 }
 
 void Step(const Grid& before, Grid& after) {
   for (int y = 0; y < kGridHeight; y++) {
     for (int x = 0; x < kGridWidth; x++) {
-      switch (before[y][x]) {
+      auto [trees, lumber_yards] = CountAdjacent(before, x, y);
+      switch (before(x, y)) {
         case Cell::kOpen:
-          after[y][x] = CountAdjacent(before, x, y, Cell::kTrees) >= 3
-                            ? Cell::kTrees
-                            : Cell::kOpen;
+          after(x, y) = trees >= 3 ? Cell::kTrees : Cell::kOpen;
           break;
         case Cell::kTrees:
-          after[y][x] = CountAdjacent(before, x, y, Cell::kLumberYard) >= 3
-                            ? Cell::kLumberYard
-                            : Cell::kTrees;
+          after(x, y) = lumber_yards >= 3 ? Cell::kLumberYard : Cell::kTrees;
           break;
         case Cell::kLumberYard:
-          after[y][x] = CountAdjacent(before, x, y, Cell::kLumberYard) >= 1 &&
-                                CountAdjacent(before, x, y, Cell::kTrees) >= 1
-                            ? Cell::kLumberYard
-                            : Cell::kOpen;
+          after(x, y) = lumber_yards >= 1 && trees >= 1 ? Cell::kLumberYard
+                                                        : Cell::kOpen;
           break;
       }
     }
@@ -71,46 +69,59 @@ void Step(const Grid& before, Grid& after) {
 }
 
 int Value(const Grid& grid) {
-  const Cell* first = &grid[0][0];
-  const Cell* last = &grid[kGridHeight][0];
-  int num_trees = std::count(first, last, Cell::kTrees);
-  int num_lumber_yards = std::count(first, last, Cell::kLumberYard);
-  return num_trees * num_lumber_yards;
+  return grid.Count(Cell::kTrees) * grid.Count(Cell::kLumberYard);
 }
 
 }  // namespace
 
-int Solve18A() {
-  Grid grids[2] = {GetInput(), {}};
+int Solve18A(std::string_view puzzle) {
+  const Grid initial = GetInput(puzzle);
+  Grid grids[2] = {initial, initial};
   for (int i = 0; i < 10; i++) Step(grids[i % 2], grids[(i + 1) % 2]);
   const Grid& result = grids[10 % 2];
   return Value(result);
 }
 
-int Solve18B() {
-  std::vector<Grid> previous;
-  Grid grids[2] = {GetInput(), {}};
-  constexpr int kMaxSearchSize = 1000;  // How long to search for a cycle.
-  for (int i = 0; i < kMaxSearchSize; i++) {
-    const Grid& before = grids[i % 2];
-    Grid& after = grids[(i + 1) % 2];
-    Step(before, after);
-    auto j = find(begin(previous), end(previous), after);
-    if (j == end(previous)) {
-      previous.push_back(after);
-    } else {
-      // This state has been seen before. We can guess generation 1'000'000'000.
-      // We are at generation i and we are at the start of a cycle. The cycle
-      // will repeat indefinitely, so we just need to work out what stage it
-      // will be at (1'000'000'000 - (i + 1)) minutes from now.
-      const int last_seen_generation = j - begin(previous);
-      const int phase = i - last_seen_generation;
-      const int remaining_generations = 1'000'000'000 - (i + 1);
-      int offset = remaining_generations % phase;
-      const Grid& final_grid = previous[last_seen_generation + offset];
-      return Value(final_grid);
+// Each generation is told apart by its fingerprint, so the history holds only
+// 8 bytes per generation rather than a whole grid.
+int Solve18B(std::string_view puzzle) {
+  Grid grid = GetInput(puzzle), next = grid;
+  StateHistory<std::uint64_t> history;
+  for (std::int64_t generation = 0;; generation++) {
+    std::uint64_t fingerprint = Fingerprint(grid.begin(), grid.end());
+    if (auto cycle = history.Record(fingerprint, generation)) {
+      // This is the same as generation cycle->start, so the target is the
+      // same distance into the cycle from here as it is from there.
+      std::int64_t remaining =
+          cycle->Equivalent(kTargetGeneration) - cycle->start;
+      for (std::int64_t i = 0; i < remaining; i++) {
+        Step(grid, next);
+        std::swap(grid, next);
+      }
+      return Value(grid);
     }
+    Step(grid, next);
+    std::swap(grid, next);
   }
-  assert(false);  // Not found.
-  return -1;
 }
+
+// Grids are cheap to compute again, so Brent's algorithm holds only two.
+int Solve18B_Brent(std::string_view puzzle) {
+  const Grid initial = GetInput(puzzle);
+  auto step = [](const Grid& before) {
+    Grid after = before;
+    Step(before, after);
+    return after;
+  };
+  Cycle cycle = FindCycle(initial, step);
+  Grid grid = initial, next = initial;
+  for (std::int64_t i = 0; i < cycle.Equivalent(kTargetGeneration); i++) {
+    Step(grid, next);
+    std::swap(grid, next);
+  }
+  return Value(grid);
+}
+
+REGISTER_SOLUTION(Solve18A);
+REGISTER_SOLUTION(Solve18B);
+REGISTER_SOLUTION(Solve18B_Brent);
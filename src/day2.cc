@@ -1,50 +1,100 @@
-#include "puzzles.h"
+#include "registry.h"
+#include "scanner.h"
+#include "stream.h"
 
 #include <algorithm>
 #include <array>
 #include <cassert>
-#include <iterator>
 #include <numeric>
-#include <sstream>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-int Solve2A() {
-  std::istringstream input{std::string{kPuzzle2}};
+namespace {
+
+// Whether any letter appears exactly twice, and whether any appears exactly
+// three times.
+std::pair<bool, bool> HasTwoAndThree(std::string_view box_id) {
+  std::array<int, 26> counts_per_letter = {};
+  for (char letter : box_id) {
+    assert(std::islower(letter));
+    counts_per_letter[letter - 'a']++;
+  }
+  auto has_count = [&](int n) {
+    return std::any_of(begin(counts_per_letter), end(counts_per_letter),
+                       [&](int count) { return count == n; });
+  };
+  return {has_count(2), has_count(3)};
+}
+
+// The letters the two IDs have in common, if they differ in exactly one place.
+std::optional<std::string> CommonLetters(std::string_view box_id,
+                                         std::string_view other_id) {
+  assert(box_id.length() == other_id.length());
+  int num_differing_letters =
+      transform_reduce(begin(box_id), end(box_id), begin(other_id), 0,
+                       std::plus<>(), std::not_equal_to<>());
+  if (num_differing_letters != 1) return std::nullopt;
+  std::string result{other_id};
+  auto [i, j] = mismatch(begin(box_id), end(box_id), begin(result));
+  result.erase(j);
+  return result;
+}
+
+}  // namespace
+
+int Solve2A(std::string_view puzzle) {
+  Scanner scanner{puzzle};
   int count_with_two = 0, count_with_three = 0;
-  for (std::string box_id; std::getline(input, box_id);) {
-    std::array<int, 26> counts_per_letter = {};
-    for (char letter : box_id) {
-      assert(std::islower(letter));
-      counts_per_letter[letter - 'a']++;
-    }
-    auto has_count = [&](int n) {
-      return std::any_of(begin(counts_per_letter), end(counts_per_letter),
-                         [&](int count) { return count == n; });
-    };
-    if (has_count(2)) count_with_two++;
-    if (has_count(3)) count_with_three++;
+  while (!scanner.done()) {
+    auto [two, three] = HasTwoAndThree(scanner.Word());
+    if (two) count_with_two++;
+    if (three) count_with_three++;
   }
   return count_with_two * count_with_three;
 }
 
-std::string Solve2B() {
-  std::istringstream input{std::string{kPuzzle2}};
-  const std::vector<std::string> box_ids{
-      std::istream_iterator<std::string>{input}, {}};
-  for (const std::string& box_id : box_ids) {
-    for (const std::string& other_id : box_ids) {
-      assert(box_id.length() == other_id.length());
-      int num_differing_letters =
-          transform_reduce(begin(box_id), end(box_id), begin(other_id), 0,
-                           std::plus<>(), std::not_equal_to<>());
-      if (num_differing_letters == 1) {
-        std::string result = other_id;
-        auto [i, j] = mismatch(begin(box_id), end(box_id), begin(result));
-        result.erase(j);
-        return result;
-      }
+int Solve2A_Stream(LineReader& lines) {
+  int count_with_two = 0, count_with_three = 0;
+  while (auto line = lines.Next()) {
+    auto [two, three] = HasTwoAndThree(*line);
+    if (two) count_with_two++;
+    if (three) count_with_three++;
+  }
+  return count_with_two * count_with_three;
+}
+
+std::string Solve2B(std::string_view puzzle) {
+  Scanner scanner{puzzle};
+  std::vector<std::string_view> box_ids;
+  while (!scanner.done()) box_ids.push_back(scanner.Word());
+  for (std::string_view box_id : box_ids) {
+    for (std::string_view other_id : box_ids) {
+      if (auto result = CommonLetters(box_id, other_id)) return *result;
     }
   }
   return "not found";
 }
+
+// Each ID is checked against those before it as it arrives. The IDs all have
+// the same length, so they are packed end to end in a single string.
+std::string Solve2B_Stream(LineReader& lines) {
+  std::string box_ids;
+  std::size_t length = 0;
+  while (auto line = lines.Next()) {
+    if (box_ids.empty()) length = line->size();
+    for (std::size_t i = 0; i < box_ids.size(); i += length) {
+      std::string_view other_id{box_ids.data() + i, length};
+      if (auto result = CommonLetters(*line, other_id)) return *result;
+    }
+    box_ids += *line;
+  }
+  return "not found";
+}
+
+REGISTER_SOLUTION(Solve2A);
+REGISTER_STREAMING_SOLUTION(Solve2A_Stream);
+REGISTER_SOLUTION(Solve2B);
+REGISTER_STREAMING_SOLUTION(Solve2B_Stream);
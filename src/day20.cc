@@ -1,12 +1,14 @@
-#include "puzzles.h"
+#include "arena.h"
+#include "flat_hash.h"
+#include "registry.h"
+#include "search.h"
+#include "trace.h"
 #include "vec2.h"
 
 #include <algorithm>
 #include <cassert>
-#include <iostream>
-#include <queue>
-#include <unordered_set>
-#include <unordered_map>
+#include <memory_resource>
+#include <string_view>
 #include <vector>
 
 namespace {
@@ -21,7 +23,9 @@ enum class Cell {
 using Dimension = int;
 using Position = vec2<Dimension>;
 
-using Grid = std::unordered_map<Position, Cell>;
+// Everything built while solving, starting with the grid, is allocated from the
+// same memory resource as the grid.
+using Grid = FlatHashMap<Position, Cell>;
 
 constexpr bool IsDirection(char c) {
   return c == 'N' || c == 'E' || c == 'S' || c == 'W';
@@ -46,15 +50,19 @@ constexpr auto Go(char direction, Grid* grid) {
 
 // Build the grid by walking along the paths described by the regex.
 struct WalkResult {
-  std::vector<Position> destinations;
+  std::pmr::vector<Position> destinations;
   std::string_view remaining_pattern;
 };
 
+// Each group in the pattern is walked by a recursive call, so traces show one
+// span per group nested inside the spans of the groups containing it.
 WalkResult Walk(std::string_view path_pattern,
-                const std::vector<Position>& start, Grid* grid) {
+                const std::pmr::vector<Position>& start, Grid* grid) {
+  TraceSpan span{"Walk"};
+  std::pmr::memory_resource* resource = grid->resource();
   std::size_t i = 0;
   std::size_t n = path_pattern.length();
-  std::vector<Position> positions = start;
+  std::pmr::vector<Position> positions{start, resource};
   while (i < n) {
     char lookahead = path_pattern[i];
     if (lookahead == '$' || lookahead == '|' || lookahead == ')') break;
@@ -68,7 +76,7 @@ WalkResult Walk(std::string_view path_pattern,
       i = j;
     } else if (lookahead == '(') {
       // Need to consider each option.
-      std::vector<Position> new_positions;
+      std::pmr::vector<Position> new_positions{resource};
       do {
         i++;
         auto temp = Walk(path_pattern.substr(i), positions, grid);
@@ -94,60 +102,73 @@ struct MeasureResult {
   int num_long_paths;
 };
 
+// Finds the distance to every room with a breadth-first search.
+template <typename Frontier>
 MeasureResult MeasurePaths(const Grid& grid, Position start) {
+  TraceSpan span{"MeasurePaths"};
   // Look up a cell in the grid. If it is not found, it is either floor or wall
   // depending solely upon whether the coordinate lines up with a cell or a wall
   // slot in the grid.
   auto cell = [&](int x, int y) {
-    auto i = grid.find({x, y});
-    if (i != grid.end()) return i->second;
+    if (const auto* entry = grid.find({x, y})) return entry->second;
     bool is_wall = x % 2 || y % 2;
     return is_wall ? Cell::kWall : Cell::kFloor;
   };
-  struct Node { Position position; int distance; };
-  int num_long_paths = 0;
-  int furthest_distance = 0;
-  std::unordered_set<Position> visited;
-  std::queue<Node> positions;
-  positions.push({start, 0});
-  while (!positions.empty()) {
-    auto [p, distance] = positions.front();
-    positions.pop();
-    auto [_, not_visited] = visited.insert(p);
-    if (not_visited) {
-      if (distance > furthest_distance) {
-        furthest_distance = distance;
-      }
-      if (distance >= 1000) num_long_paths++;
-      if (cell(p.x, p.y - 1) == Cell::kHorizontalDoor)
-        positions.push({{p.x, p.y - 2}, distance + 1});
-      if (cell(p.x + 1, p.y) == Cell::kVerticalDoor)
-        positions.push({{p.x + 2, p.y}, distance + 1});
-      if (cell(p.x, p.y + 1) == Cell::kHorizontalDoor)
-        positions.push({{p.x, p.y + 2}, distance + 1});
-      if (cell(p.x - 1, p.y) == Cell::kVerticalDoor)
-        positions.push({{p.x - 2, p.y}, distance + 1});
-    }
-  }
-  return MeasureResult{furthest_distance, num_long_paths};
+  auto expand = [&](Position p, auto push) {
+    if (cell(p.x, p.y - 1) == Cell::kHorizontalDoor) push({p.x, p.y - 2}, 1);
+    if (cell(p.x + 1, p.y) == Cell::kVerticalDoor) push({p.x + 2, p.y}, 1);
+    if (cell(p.x, p.y + 1) == Cell::kHorizontalDoor) push({p.x, p.y + 2}, 1);
+    if (cell(p.x - 1, p.y) == Cell::kVerticalDoor) push({p.x - 2, p.y}, 1);
+  };
+  MeasureResult result{0, 0};
+  auto settle = [&](Position, int distance) {
+    result.longest_path = std::max(result.longest_path, distance);
+    if (distance >= 1000) result.num_long_paths++;
+    return false;
+  };
+  std::pmr::memory_resource* resource = grid.resource();
+  Frontier frontier{resource};
+  HashedVisited<Position> visited{resource};
+  Search(start, frontier, visited, expand, settle);
+  return result;
 }
 
-}  // namespace
-
-int Solve20A() {
+template <typename Frontier>
+MeasureResult MeasurePaths(std::string_view puzzle) {
   // Remove the ^ and also the trailing \n (but not the $).
-  auto pattern = kPuzzle20.substr(1, kPuzzle20.length() - 2);
-  Grid grid;
-  auto result = Walk(pattern, {{0, 0}}, &grid);
+  auto pattern = puzzle.substr(1, puzzle.length() - 2);
+  Arena arena;
+  Grid grid{&arena};
+  auto result = Walk(pattern, std::pmr::vector<Position>{{{0, 0}}, &arena},
+                     &grid);
   assert(result.remaining_pattern == "$");
-  return MeasurePaths(grid, {0, 0}).longest_path;
+  return MeasurePaths<Frontier>(grid, {0, 0});
 }
 
-int Solve20B() {
-  // Remove the ^ and also the trailing \n (but not the $).
-  auto pattern = kPuzzle20.substr(1, kPuzzle20.length() - 2);
-  Grid grid;
-  auto result = Walk(pattern, {{0, 0}}, &grid);
-  assert(result.remaining_pattern == "$");
-  return MeasurePaths(grid, {0, 0}).num_long_paths;
+}  // namespace
+
+int Solve20A(std::string_view puzzle) {
+  return MeasurePaths<FifoFrontier<Position>>(puzzle).longest_path;
+}
+
+int Solve20B(std::string_view puzzle) {
+  return MeasurePaths<FifoFrontier<Position>>(puzzle).num_long_paths;
+}
+
+int Solve20A_Bucket(std::string_view puzzle) {
+  return MeasurePaths<BucketFrontier<Position>>(puzzle).longest_path;
 }
+
+int Solve20A_RadixHeap(std::string_view puzzle) {
+  return MeasurePaths<RadixHeap<Position>>(puzzle).longest_path;
+}
+
+int Solve20A_Heap(std::string_view puzzle) {
+  return MeasurePaths<HeapFrontier<Position>>(puzzle).longest_path;
+}
+
+REGISTER_SOLUTION(Solve20A);
+REGISTER_SOLUTION(Solve20B);
+REGISTER_SOLUTION(Solve20A_Bucket);
+REGISTER_SOLUTION(Solve20A_RadixHeap);
+REGISTER_SOLUTION(Solve20A_Heap);
@@ -1,26 +1,19 @@
-#include "puzzles.h"
+#include "grid2d.h"
+#include "registry.h"
+#include "scanner.h"
+#include "search.h"
 
 #include "vec2.h"
 
 #include <array>
 #include <cassert>
-#include <iostream>
 #include <limits>
 #include <numeric>
-#include <queue>
-#include <unordered_set>
+#include <string_view>
 #include <vector>
 
 namespace {
 
-int svtoi(std::string_view input) {
-  const char* begin = input.data();
-  char* end = nullptr;
-  int result = std::strtol(begin, &end, 10);
-  assert(begin != end);
-  return result;
-}
-
 using Position = vec2<short>;
 
 struct Input { int depth; Position target; };
@@ -32,14 +25,14 @@ constexpr bool operator==(Configuration a, Configuration b) {
   return a.position == b.position && a.tool == b.tool;
 }
 
-Input GetInput() {
-  assert(kPuzzle22.substr(0, 7) == "depth: ");
-  int depth = svtoi(kPuzzle22.substr(7));
-  auto target_label = kPuzzle22.find("target: ");
-  assert(target_label != std::string_view::npos);
-  int x = svtoi(kPuzzle22.substr(target_label + 8));
-  auto comma = kPuzzle22.find(',', target_label);
-  int y = svtoi(kPuzzle22.substr(comma + 1));
+Input GetInput(std::string_view puzzle) {
+  Scanner scanner{puzzle};
+  scanner.Expect("depth:");
+  int depth = scanner.Int();
+  scanner.Expect("target:");
+  short x = scanner.Int<short>();
+  scanner.Expect(",");
+  short y = scanner.Int<short>();
   assert(0 <= depth && depth < 20183);
   assert(0 < x);
   assert(0 < y);
@@ -68,17 +61,17 @@ constexpr bool Compatible(Cell cell, Tool tool) {
 
 }  // namespace
 
+// The tool only changes the low bits, which pick the group, so the
+// configurations for a position are spread over nearby groups.
 template <>
 struct std::hash<Configuration> {
   constexpr std::size_t operator()(Configuration configuration) const {
-    return (configuration.position.x * 107) ^
-           (configuration.position.y * 5) ^
-           configuration.tool;
+    return std::hash<Position>{}(configuration.position) ^ configuration.tool;
   }
 };
 
-int Solve22A() {
-  auto [depth, target] = GetInput();
+int Solve22A(std::string_view puzzle) {
+  auto [depth, target] = GetInput(puzzle);
   std::vector<int> row;
   row.reserve(target.x + 1);
   row.push_back(depth);
@@ -106,65 +99,116 @@ int Solve22A() {
   return risk_total;
 }
 
-int Solve22B() {
-  auto [depth, target] = GetInput();
-  // Build the grid.
+namespace {
+
+// The erosion level of every region from the mouth of the cave to a little way
+// beyond the target in each direction.
+Grid2D<short> ErosionLevels(int depth, Position target) {
   int grid_width = std::max(target.x, target.y) + 10;
   int grid_height = std::max(target.x, target.y) + 10;
   assert(grid_width * grid_height < 10'000'000);
-  std::vector<short> grid;
-  grid.reserve(grid_width * grid_height);
-  grid.push_back(depth);
+  Grid2D<short> erosion{grid_width, grid_height};
+  erosion(0, 0) = depth;
   for (int x = 1; x < grid_width; x++)
-    grid.push_back((x * 16807 + depth) % 20183);
+    erosion(x, 0) = (x * 16807 + depth) % 20183;
   for (int y = 1; y < grid_height; y++) {
-    int offset = grid_width * y;
-    grid.push_back((y * 48271 + depth) % 20183);
+    erosion(0, y) = (y * 48271 + depth) % 20183;
     for (int x = 1; x < grid_width; x++) {
-      int left = grid[offset + x - 1];
-      int above = grid[offset + x - grid_width];
+      int left = erosion(x - 1, y);
+      int above = erosion(x, y - 1);
       if (x == target.x && y == target.y) {
-        grid.push_back(depth);
+        erosion(x, y) = depth;
       } else {
-        grid.push_back((left * above + depth) % 20183);
+        erosion(x, y) = (left * above + depth) % 20183;
       }
     }
   }
-  auto cell = [&](int x, int y) { return Cell(grid[y * grid_width + x] % 3); };
-  // Search for the cell.
-  std::unordered_set<Configuration> explored;
-  struct Node { short time, cost; Configuration configuration; };
-  auto make_node = [target=target](short time, Configuration configuration) {
-    const auto& [pos, tool] = configuration;
-    int min_travel_time = abs(target.x - pos.x) + abs(target.y - pos.y);
-    int tool_switch_time = tool == kTorch ? 0 : 7;
-    short cost = time + min_travel_time + tool_switch_time;
-    return Node{time, cost, configuration};
-  };
-  auto by_cost = [](const Node& a, const Node& b) { return a.cost > b.cost; };
-  std::priority_queue<Node, std::vector<Node>, decltype(by_cost)> frontier{
-      by_cost};
-  frontier.push(make_node(0, Configuration{{0, 0}, kTorch}));
-  while (true) {
-    assert(!frontier.empty());
-    Node node = frontier.top();
-    frontier.pop();
-    if (node.configuration == Configuration{target, kTorch}) return node.time;
-    auto [i, was_inserted] = explored.insert(node.configuration);
-    if (!was_inserted) continue;  // Already explored.
-    Cell current_cell =
-        cell(node.configuration.position.x, node.configuration.position.y);
-    for (Position p : AdjacentSquares(node.configuration.position)) {
+  return erosion;
+}
+
+// Finds the quickest way to reach the target holding the torch with A*. The
+// heuristic is the time to walk straight there and then switch to the torch,
+// which is consistent, and raises the priority by at most 16 per step.
+template <typename Frontier, typename Visited>
+int QuickestTime(const Grid2D<short>& erosion, Position target,
+                 Frontier& frontier, Visited& visited) {
+  auto cell = [&](Position p) { return Cell(erosion[p] % 3); };
+  auto expand = [&](Configuration configuration, auto push) {
+    Cell current_cell = cell(configuration.position);
+    for (Position p : AdjacentSquares(configuration.position)) {
       if (p.x < 0) continue;
       if (p.y < 0) continue;
-      assert(p.x < grid_width);
-      assert(p.y < grid_height);
-      for (Tool t : CompatibleTools(cell(p.x, p.y))) {
+      assert(p.x < erosion.width());
+      assert(p.y < erosion.height());
+      for (Tool t : CompatibleTools(cell(p))) {
         if (!Compatible(current_cell, t)) continue;  // Can't switch to tool.
-        short time = node.time + 1;
-        if (t != node.configuration.tool) time += 7;
-        frontier.push(make_node(time, {p, t}));
+        push(Configuration{p, t}, t == configuration.tool ? 1 : 8);
       }
     }
+  };
+  const Configuration goal{target, kTorch};
+  int result = -1;
+  auto settle = [&](Configuration configuration, int time) {
+    if (!(configuration == goal)) return false;
+    result = time;
+    return true;
+  };
+  auto heuristic = [target](Configuration configuration) {
+    const auto& [pos, tool] = configuration;
+    int min_travel_time = abs(target.x - pos.x) + abs(target.y - pos.y);
+    int tool_switch_time = tool == kTorch ? 0 : 7;
+    return min_travel_time + tool_switch_time;
+  };
+  [[maybe_unused]] bool found = Search(Configuration{{0, 0}, kTorch}, frontier,
+                                       visited, expand, settle, heuristic);
+  assert(found);
+  return result;
+}
+
+// Each configuration is numbered by its region and then its tool.
+struct ConfigurationIndex {
+  int grid_width;
+  std::size_t operator()(Configuration configuration) const {
+    const auto& [pos, tool] = configuration;
+    return (std::size_t(pos.y) * grid_width + pos.x) * 3 + tool;
   }
+};
+
+template <typename Frontier>
+int Solve22BWith(std::string_view puzzle) {
+  auto [depth, target] = GetInput(puzzle);
+  const Grid2D<short> erosion = ErosionLevels(depth, target);
+  Frontier frontier;
+  DenseVisited visited{std::size_t(erosion.width()) * erosion.height() * 3,
+                       ConfigurationIndex{erosion.width()}};
+  return QuickestTime(erosion, target, frontier, visited);
 }
+
+}  // namespace
+
+int Solve22B(std::string_view puzzle) {
+  return Solve22BWith<BucketFrontier<Configuration>>(puzzle);
+}
+
+int Solve22B_RadixHeap(std::string_view puzzle) {
+  return Solve22BWith<RadixHeap<Configuration>>(puzzle);
+}
+
+int Solve22B_Heap(std::string_view puzzle) {
+  return Solve22BWith<HeapFrontier<Configuration>>(puzzle);
+}
+
+// The visited configurations in a hash set rather than a bitmap.
+int Solve22B_Hashed(std::string_view puzzle) {
+  auto [depth, target] = GetInput(puzzle);
+  const Grid2D<short> erosion = ErosionLevels(depth, target);
+  BucketFrontier<Configuration> frontier;
+  HashedVisited<Configuration> visited;
+  return QuickestTime(erosion, target, frontier, visited);
+}
+
+REGISTER_SOLUTION(Solve22A);
+REGISTER_SOLUTION(Solve22B);
+REGISTER_SOLUTION(Solve22B_RadixHeap);
+REGISTER_SOLUTION(Solve22B_Heap);
+REGISTER_SOLUTION(Solve22B_Hashed);
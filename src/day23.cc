@@ -1,8 +1,10 @@
-#include "puzzles.h"
+#include "integers.h"
+#include "registry.h"
 
 #include <algorithm>
 #include <cassert>
 #include <optional>
+#include <string_view>
 #include <vector>
 
 namespace {
@@ -15,34 +17,15 @@ struct Space {
   std::vector<HalfSpace> sides;
 };
 
-int svtoi(std::string_view input) {
-  const char* begin = input.data();
-  char* end = nullptr;
-  int result = std::strtol(begin, &end, 10);
-  assert(begin != end);
-  return result;
-}
-
-std::vector<Nanobot> GetInput() {
+std::vector<Nanobot> GetInput(std::string_view puzzle) {
+  // pos=<26057576,-10751309,46491633>, r=91461401
+  const std::vector<int> numbers = ExtractAllIntegers(puzzle);
+  assert(numbers.size() % 4 == 0);
   std::vector<Nanobot> nanobots;
-  std::size_t i = 0;
-  auto jump_after = [&i](char needle) {
-    auto j = kPuzzle23.find(needle, i);
-    assert(j != std::string_view::npos);
-    i = j + 1;
-  };
-  auto remaining_input = [&] { return kPuzzle23.substr(i); };
-  while (!remaining_input().empty()) {
-    jump_after('<');
-    auto x = svtoi(remaining_input());
-    jump_after(',');
-    auto y = svtoi(remaining_input());
-    jump_after(',');
-    auto z = svtoi(remaining_input());
-    jump_after('=');
-    auto r = svtoi(remaining_input());
-    nanobots.push_back(Nanobot{{x, y, z}, r});
-    jump_after('\n');
+  nanobots.reserve(numbers.size() / 4);
+  for (std::size_t i = 0; i + 4 <= numbers.size(); i += 4) {
+    nanobots.push_back(Nanobot{{numbers[i], numbers[i + 1], numbers[i + 2]},
+                               numbers[i + 3]});
   }
   return nanobots;
 }
@@ -53,8 +36,8 @@ auto distance(Vector a, Vector b) {
 
 }  // namespace
 
-int Solve23A() {
-  auto nanobots = GetInput();
+int Solve23A(std::string_view puzzle) {
+  auto nanobots = GetInput(puzzle);
   assert(!nanobots.empty());
   auto by_range = [](const Nanobot& a, const Nanobot& b) {
     return a.range < b.range;
@@ -68,3 +51,5 @@ int Solve23A() {
   auto num_in_range = count_if(begin(nanobots), end(nanobots), in_range);
   return num_in_range;
 }
+
+REGISTER_SOLUTION(Solve23A);
@@ -1,13 +1,11 @@
-#include "puzzles.h"
+#include "registry.h"
+#include "scanner.h"
+#include "stream.h"
 
+#include <algorithm>
 #include <array>
-#include <cassert>
-#include <iterator>
-#include <iostream>
-#include <regex>
-#include <sstream>
-#include <string>
 #include <string_view>
+#include <vector>
 
 namespace {
 
@@ -20,42 +18,48 @@ struct Claim {
   Rectangle rectangle;
 };
 
-int svtoi(std::string_view input) {
-  const char* begin = input.data();
-  char* end = nullptr;
-  int result = std::strtol(begin, &end, 10);
-  assert(begin != end);
-  return result;
+// #1 @ 1,3: 4x4
+Claim ParseClaim(Scanner& scanner) {
+  Claim claim;
+  scanner.Expect("#");
+  claim.id = scanner.Int();
+  scanner.Expect("@");
+  claim.rectangle.x = scanner.Int();
+  scanner.Expect(",");
+  claim.rectangle.y = scanner.Int();
+  scanner.Expect(":");
+  claim.rectangle.width = scanner.Int();
+  scanner.Expect("x");
+  claim.rectangle.height = scanner.Int();
+  return claim;
 }
 
-std::istream& operator>>(std::istream& input, Claim& claim) {
-  std::string line_data;
-  if (!std::getline(input, line_data)) return input;
-  std::string_view line{line_data};
-  claim.id = svtoi(line.substr(1));
-  claim.rectangle.x = svtoi(line.substr(line.find('@') + 1));
-  claim.rectangle.y = svtoi(line.substr(line.find(',') + 1));
-  claim.rectangle.width = svtoi(line.substr(line.find(':') + 1));
-  claim.rectangle.height = svtoi(line.substr(line.find('x') + 1));
-  return input;
+Claim ParseClaim(std::string_view line) {
+  Scanner scanner{line};
+  return ParseClaim(scanner);
 }
 
-}  // namespace
+std::vector<Claim> GetClaims(std::string_view puzzle) {
+  std::vector<Claim> claims;
+  Scanner scanner{puzzle};
+  while (!scanner.done()) claims.push_back(ParseClaim(scanner));
+  return claims;
+}
+
+// The number of claims covering each square inch.
+using Fabric = std::array<std::array<char, 1000>, 1000>;
 
-int Solve3A() {
-  std::istringstream input{std::string{kPuzzle3}};
-  std::vector<Claim> claims{std::istream_iterator<Claim>{input}, {}};
-  std::array<std::array<char, 1000>, 1000> fabric = {};
-  auto blit = [&fabric](const Rectangle& rectangle) {
-    int x_max = rectangle.x + rectangle.width,
-        y_max = rectangle.y + rectangle.height;
-    for (int y = rectangle.y; y < y_max; y++) {
-      for (int x = rectangle.x; x < x_max; x++) {
-        fabric[y][x]++;
-      }
+void Blit(Fabric& fabric, const Rectangle& rectangle) {
+  int x_max = rectangle.x + rectangle.width,
+      y_max = rectangle.y + rectangle.height;
+  for (int y = rectangle.y; y < y_max; y++) {
+    for (int x = rectangle.x; x < x_max; x++) {
+      fabric[y][x]++;
     }
-  };
-  for (const Claim& claim : claims) blit(claim.rectangle);
+  }
+}
+
+int CountOverlapping(const Fabric& fabric) {
   int overlapping = 0;
   for (const auto& row : fabric) {
     for (char cell : row) {
@@ -65,9 +69,7 @@ int Solve3A() {
   return overlapping;
 }
 
-int Solve3B() {
-  std::istringstream input{std::string{kPuzzle3}};
-  std::vector<Claim> claims{std::istream_iterator<Claim>{input}, {}};
+int FindIntactClaim(const std::vector<Claim>& claims) {
   for (const Claim& claim : claims) {
     auto overlaps = [&](const Claim& other) {
       const Rectangle& a = claim.rectangle;
@@ -80,3 +82,34 @@ int Solve3B() {
   }
   return -1;
 }
+
+}  // namespace
+
+int Solve3A(std::string_view puzzle) {
+  std::vector<Claim> claims = GetClaims(puzzle);
+  Fabric fabric = {};
+  for (const Claim& claim : claims) Blit(fabric, claim.rectangle);
+  return CountOverlapping(fabric);
+}
+
+// Only the fabric is needed, so each claim is dropped once it is applied.
+int Solve3A_Stream(LineReader& lines) {
+  Fabric fabric = {};
+  while (auto line = lines.Next()) Blit(fabric, ParseClaim(*line).rectangle);
+  return CountOverlapping(fabric);
+}
+
+int Solve3B(std::string_view puzzle) {
+  return FindIntactClaim(GetClaims(puzzle));
+}
+
+int Solve3B_Stream(LineReader& lines) {
+  std::vector<Claim> claims;
+  while (auto line = lines.Next()) claims.push_back(ParseClaim(*line));
+  return FindIntactClaim(claims);
+}
+
+REGISTER_SOLUTION(Solve3A);
+REGISTER_STREAMING_SOLUTION(Solve3A_Stream);
+REGISTER_SOLUTION(Solve3B);
+REGISTER_STREAMING_SOLUTION(Solve3B_Stream);
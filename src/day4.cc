@@ -1,14 +1,13 @@
-#include "puzzles.h"
+#include "registry.h"
+#include "scanner.h"
+#include "stream.h"
 
 #include <algorithm>
 #include <array>
 #include <cassert>
-#include <iostream>
-#include <iterator>
-#include <sstream>
-#include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -41,43 +40,48 @@ constexpr bool operator<(const LogEntry& left, const LogEntry& right) {
   return left.when < right.when;
 }
 
-int svtoi(std::string_view input) {
-  const char* begin = input.data();
-  char* end = nullptr;
-  int result = std::strtol(begin, &end, 10);
-  assert(begin != end);
-  return result;
+LogEntry ParseEntry(Scanner& scanner) {
+  LogEntry entry;
+  // [YYYY-mm-dd HH:MM] Message
+  // The fields are read as unsigned so that the dashes aren't taken as signs.
+  scanner.Expect("[");
+  entry.when.year = scanner.Int<unsigned int>();
+  scanner.Expect("-");
+  entry.when.month = scanner.Int<unsigned char>();
+  scanner.Expect("-");
+  entry.when.day = scanner.Int<unsigned char>();
+  entry.when.hour = scanner.Int<unsigned char>();
+  scanner.Expect(":");
+  entry.when.minute = scanner.Int<unsigned char>();
+  scanner.Expect("]");
+  if (scanner.Consume("Guard #")) {
+    entry.data = GuardStarts{scanner.Int<short>()};
+    scanner.Expect("begins shift");
+  } else if (scanner.Consume("falls asleep")) {
+    entry.data = FallsAsleep{};
+  } else {
+    scanner.Expect("wakes up");
+    entry.data = WakesUp{};
+  }
+  return entry;
 }
 
-std::istream& operator>>(std::istream& input, LogEntry& entry) {
-  std::string line_data;
-  if (!std::getline(input, line_data)) return input;
-  std::string_view line{line_data};
-  assert(line.length() >= 20);
-  assert(line[17] == ']');
-  // [YYYY-mm-dd HH:MM] Message
-  //  ^1   ^6 ^9 ^12^15 ^19
-  entry.when.year = svtoi(line.substr(1));
-  entry.when.month = svtoi(line.substr(6));
-  entry.when.day = svtoi(line.substr(9));
-  entry.when.hour = svtoi(line.substr(12));
-  entry.when.minute = svtoi(line.substr(15));
-  switch (line[19]) {
-    case 'G':
-      // [YYYY-mm-dd HH:MM] Guard #N begins shift
-      //                           ^26
-      entry.data = GuardStarts{static_cast<short>(svtoi(line.substr(26)))};
-      break;
-    case 'f':
-      entry.data = FallsAsleep{};
-      break;
-    case 'w':
-      entry.data = WakesUp{};
-      break;
-    default:
-      assert(false);
+std::vector<LogEntry> GetEntries(std::string_view puzzle) {
+  Scanner scanner{puzzle};
+  std::vector<LogEntry> entries;
+  while (!scanner.done()) entries.push_back(ParseEntry(scanner));
+  return entries;
+}
+
+// The log is out of order, so every entry has to be kept until it is sorted,
+// but only in its parsed form.
+std::vector<LogEntry> ReadEntries(LineReader& lines) {
+  std::vector<LogEntry> entries;
+  while (auto line = lines.Next()) {
+    Scanner scanner{*line};
+    entries.push_back(ParseEntry(scanner));
   }
-  return input;
+  return entries;
 }
 
 struct GuardEntry {
@@ -86,9 +90,7 @@ struct GuardEntry {
   std::array<char, 60> frequency_per_minute;
 };
 
-std::vector<GuardEntry> SleepPerGuard() {
-  std::istringstream input{std::string{kPuzzle4}};
-  std::vector<LogEntry> entries{std::istream_iterator<LogEntry>{input}, {}};
+std::vector<GuardEntry> SleepPerGuard(std::vector<LogEntry> entries) {
   sort(begin(entries), end(entries));
   assert(std::holds_alternative<GuardStarts>(entries[0].data));
   std::vector<GuardEntry> sleep_per_guard;
@@ -123,10 +125,9 @@ const auto* MostSleptMinute(const GuardEntry& entry) {
                           end(entry.frequency_per_minute));
 }
 
-}  // namespace
-
-int Solve4A() {
-  auto sleep_per_guard = SleepPerGuard();
+// Strategy 1: the guard who sleeps the most, times their most slept minute.
+int MostAsleepGuard(std::vector<LogEntry> entries) {
+  auto sleep_per_guard = SleepPerGuard(std::move(entries));
   auto i = max_element(begin(sleep_per_guard), end(sleep_per_guard),
                        [](const auto& a, const auto& b) {
                          return a.total_minutes < b.total_minutes;
@@ -135,8 +136,10 @@ int Solve4A() {
   return i->guard_id * most_slept_minute;
 }
 
-int Solve4B() {
-  auto sleep_per_guard = SleepPerGuard();
+// Strategy 2: the guard who is most often asleep on the same minute, times
+// that minute.
+int MostRegularGuard(std::vector<LogEntry> entries) {
+  auto sleep_per_guard = SleepPerGuard(std::move(entries));
   auto i = max_element(begin(sleep_per_guard), end(sleep_per_guard),
                        [&](const auto& a, const auto& b) {
                          return *MostSleptMinute(a) < *MostSleptMinute(b);
@@ -144,3 +147,26 @@ int Solve4B() {
   int minute = MostSleptMinute(*i) - begin(i->frequency_per_minute);
   return i->guard_id * minute;
 }
+
+}  // namespace
+
+int Solve4A(std::string_view puzzle) {
+  return MostAsleepGuard(GetEntries(puzzle));
+}
+
+int Solve4A_Stream(LineReader& lines) {
+  return MostAsleepGuard(ReadEntries(lines));
+}
+
+int Solve4B(std::string_view puzzle) {
+  return MostRegularGuard(GetEntries(puzzle));
+}
+
+int Solve4B_Stream(LineReader& lines) {
+  return MostRegularGuard(ReadEntries(lines));
+}
+
+REGISTER_SOLUTION(Solve4A);
+REGISTER_STREAMING_SOLUTION(Solve4A_Stream);
+REGISTER_SOLUTION(Solve4B);
+REGISTER_STREAMING_SOLUTION(Solve4B_Stream);
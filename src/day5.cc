@@ -1,23 +1,27 @@
-#include "puzzles.h"
+#include "registry.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cctype>
-#include <iostream>
 #include <iterator>
 #include <list>
+#include <string_view>
 
 namespace {
 
 // The puzzle input ends with a newline. We don't want that. Remove it.
-const std::string_view kTrimmedPuzzle = kPuzzle5.substr(0, kPuzzle5.size() - 1);
+std::string_view TrimmedPuzzle(std::string_view puzzle) {
+  return puzzle.substr(0, puzzle.size() - 1);
+}
 
 // Uppercase and lowercase ascii differ only by bit 0x20.
 constexpr char kLowerCaseBit = 0x20;
 
 bool UnitsReact(char a, char b) { return (a ^ b ^ kLowerCaseBit) == 0; }
 
-int React(std::string polymer) {
+// React the polymer fully. The remaining units are left at the start of it and
+// their number is returned.
+std::size_t ReactInPlace(std::string& polymer) {
   std::size_t n = polymer.size();
   std::size_t gap_size = 0;
   std::size_t i = 0;
@@ -45,17 +49,40 @@ int React(std::string polymer) {
   return n - gap_size;
 }
 
+int React(std::string polymer) { return ReactInPlace(polymer); }
+
 }  // namespace
 
-int Solve5A() {
+int Solve5A(std::string_view puzzle) {
   // We have std::prev because the input ends in a newline.
-  return React(std::string{kTrimmedPuzzle});
+  return React(std::string{TrimmedPuzzle(puzzle)});
+}
+
+int Solve5B(std::string_view puzzle) {
+  int best_length = puzzle.length();
+  for (char c = 'a'; c <= 'z'; c++) {
+    std::string polymer{TrimmedPuzzle(puzzle)};
+    auto i = remove_if(begin(polymer), end(polymer), [c](char c2) {
+      return (c2 | kLowerCaseBit) == c;
+    });
+    polymer.erase(i, end(polymer));
+    int length = React(std::move(polymer));
+    if (length < best_length) {
+      best_length = length;
+    }
+  }
+  return best_length;
 }
 
-int Solve5B() {
-  int best_length = kPuzzle5.length();
+// Any pair which reacts in the full polymer still reacts once a unit type has
+// been removed, so the search can start from the reacted polymer instead, which
+// is far shorter.
+int Solve5B_ReactFirst(std::string_view puzzle) {
+  std::string reacted{TrimmedPuzzle(puzzle)};
+  reacted.resize(ReactInPlace(reacted));
+  int best_length = reacted.length();
   for (char c = 'a'; c <= 'z'; c++) {
-    std::string polymer{kTrimmedPuzzle};
+    std::string polymer = reacted;
     auto i = remove_if(begin(polymer), end(polymer), [c](char c2) {
       return (c2 | kLowerCaseBit) == c;
     });
@@ -67,3 +94,7 @@ int Solve5B() {
   }
   return best_length;
 }
+
+REGISTER_SOLUTION(Solve5A);
+REGISTER_SOLUTION(Solve5B);
+REGISTER_SOLUTION(Solve5B_ReactFirst);
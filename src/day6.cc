@@ -1,12 +1,11 @@
-#include "puzzles.h"
+#include "registry.h"
+#include "scanner.h"
 
 #include <algorithm>
 #include <cassert>
-#include <iterator>
 #include <limits>
 #include <numeric>
-#include <sstream>
-#include <string>
+#include <string_view>
 #include <tuple>
 #include <variant>
 #include <vector>
@@ -23,11 +22,6 @@ struct Coordinate {
 enum class Draw : unsigned char {};
 using Closest = std::variant<Id, Draw>;
 
-std::istream& operator>>(std::istream& input, Coordinate& coordinate) {
-  char comma;
-  return input >> coordinate.x >> comma >> coordinate.y;
-}
-
 constexpr bool operator<(Coordinate a, Coordinate b) {
   return std::tie(a.x, a.y) < std::tie(b.x, b.y);
 }
@@ -50,10 +44,15 @@ struct Input {
   Coordinate size;
 };
 
-Input GetAdjustedCoordinates() {
-  std::istringstream input{std::string{kPuzzle6}};
-  std::vector<Coordinate> coordinates{
-      std::istream_iterator<Coordinate>{input}, {}};
+Input GetAdjustedCoordinates(std::string_view puzzle) {
+  Scanner scanner{puzzle};
+  std::vector<Coordinate> coordinates;
+  while (!scanner.done()) {
+    Coordinate& coordinate = coordinates.emplace_back();
+    coordinate.x = scanner.Int<Dimension>();
+    scanner.Expect(",");
+    coordinate.y = scanner.Int<Dimension>();
+  }
   assert(!coordinates.empty());
   assert(coordinates.size() < std::numeric_limits<Id>::max());
   sort(begin(coordinates), end(coordinates));
@@ -75,8 +74,8 @@ Input GetAdjustedCoordinates() {
 
 }  // namespace
 
-int Solve6A() {
-  auto [coordinates, size] = GetAdjustedCoordinates();
+int Solve6A(std::string_view puzzle) {
+  auto [coordinates, size] = GetAdjustedCoordinates(puzzle);
   Id n = coordinates.size();
   std::vector<Closest> grid_buffer(size.x * size.y);
   std::vector<int> areas(n);
@@ -126,8 +125,8 @@ int Solve6A() {
   return max_area;
 }
 
-int Solve6B() {
-  auto [coordinates, size] = GetAdjustedCoordinates();
+int Solve6B(std::string_view puzzle) {
+  auto [coordinates, size] = GetAdjustedCoordinates(puzzle);
   std::vector<Closest> grid_buffer(size.x * size.y);
   int area = 0;
   for (Dimension y = 0; y < size.y; y++) {
@@ -147,3 +146,6 @@ int Solve6B() {
   }
   return area;
 }
+
+REGISTER_SOLUTION(Solve6A);
+REGISTER_SOLUTION(Solve6B);
@@ -1,33 +1,45 @@
-#include "puzzles.h"
+#include "registry.h"
+#include "scanner.h"
+#include "stream.h"
 
 #include <algorithm>
 #include <array>
 #include <cassert>
-#include <iostream>
-#include <iterator>
 #include <queue>
-#include <sstream>
 #include <string>
+#include <string_view>
 
 namespace {
 
-struct Dependency {
-  char before, after;
-};
+// dependencies[x][y] is true if x depends on y.
+using Dependencies = std::array<std::array<bool, 26>, 26>;
+
+void AddDependency(Scanner& scanner, Dependencies& dependencies) {
+  scanner.Expect("Step");
+  char before = scanner.Char();
+  assert('A' <= before && before <= 'Z');
+  scanner.Expect("must be finished before step");
+  char after = scanner.Char();
+  assert('A' <= after && after <= 'Z');
+  scanner.Expect("can begin.");
+  dependencies[after - 'A'][before - 'A'] = true;
+}
 
-std::istream& operator>>(std::istream& input, Dependency& dependency) {
-  std::string line_data;
-  if (!std::getline(input, line_data)) return input;
-  std::string_view line = line_data;
-  assert(line_data.length() == 48);
-  assert(line.substr(0, 5) == "Step ");
-  assert('A' <= line[5] && line[5] <= 'Z');
-  assert(line.substr(6, 30) == " must be finished before step ");
-  assert('A' <= line[36] && line[36] <= 'Z');
-  assert(line.substr(37) == " can begin.");
-  dependency.before = line[5];
-  dependency.after = line[36];
-  return input;
+Dependencies GetDependencies(std::string_view puzzle) {
+  Dependencies dependencies = {};
+  Scanner scanner{puzzle};
+  while (!scanner.done()) AddDependency(scanner, dependencies);
+  return dependencies;
+}
+
+// The dependencies are a fixed-size table, so nothing else needs to be kept.
+Dependencies ReadDependencies(LineReader& lines) {
+  Dependencies dependencies = {};
+  while (auto line = lines.Next()) {
+    Scanner scanner{*line};
+    AddDependency(scanner, dependencies);
+  }
+  return dependencies;
 }
 
 struct WorkEntry {
@@ -39,15 +51,7 @@ constexpr bool operator>(WorkEntry a, WorkEntry b) {
   return a.finish_time > b.finish_time;
 }
 
-}  // namespace
-
-std::string Solve7A() {
-  // dependencies[x][y] is true if x depends on y.
-  std::array<std::array<bool, 26>, 26> dependencies = {};
-  std::istringstream input{std::string{kPuzzle7}};
-  for (std::istream_iterator<Dependency> i{input}, end{}; i != end; i++) {
-    dependencies[i->after - 'A'][i->before - 'A'] = true;
-  }
+std::string Order(Dependencies dependencies) {
   std::array<bool, 26> done = {};
   auto is_ready = [&](auto& target) {
     char index = &target - &dependencies[0];
@@ -68,13 +72,7 @@ std::string Solve7A() {
   return order;
 }
 
-int Solve7B() {
-  // dependencies[x][y] is true if x depends on y.
-  std::array<std::array<bool, 26>, 26> dependencies = {};
-  std::istringstream input{std::string{kPuzzle7}};
-  for (std::istream_iterator<Dependency> i{input}, end{}; i != end; i++) {
-    dependencies[i->after - 'A'][i->before - 'A'] = true;
-  }
+int CompletionTime(Dependencies dependencies) {
   std::array<bool, 26> started = {};
   auto is_ready = [&](auto& target) {
     char index = &target - &dependencies[0];
@@ -103,3 +101,26 @@ int Solve7B() {
   }
   return time;
 }
+
+}  // namespace
+
+std::string Solve7A(std::string_view puzzle) {
+  return Order(GetDependencies(puzzle));
+}
+
+std::string Solve7A_Stream(LineReader& lines) {
+  return Order(ReadDependencies(lines));
+}
+
+int Solve7B(std::string_view puzzle) {
+  return CompletionTime(GetDependencies(puzzle));
+}
+
+int Solve7B_Stream(LineReader& lines) {
+  return CompletionTime(ReadDependencies(lines));
+}
+
+REGISTER_SOLUTION(Solve7A);
+REGISTER_STREAMING_SOLUTION(Solve7A_Stream);
+REGISTER_SOLUTION(Solve7B);
+REGISTER_STREAMING_SOLUTION(Solve7B_Stream);
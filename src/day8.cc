@@ -1,26 +1,30 @@
-#include "puzzles.h"
+#include "arena.h"
+#include "registry.h"
+#include "scanner.h"
 
 #include <cassert>
-#include <iostream>
-#include <iterator>
+#include <memory_resource>
 #include <numeric>
-#include <sstream>
-#include <stack>
-#include <string>
+#include <string_view>
 #include <vector>
 
 namespace {
 
+// The whole tree is allocated from a single arena.
 struct Node {
-  std::vector<Node> children;
-  std::vector<short> metadata;
+  explicit Node(std::pmr::memory_resource* resource)
+      : children(resource), metadata(resource) {}
+
+  std::pmr::vector<Node> children;
+  std::pmr::vector<short> metadata;
 };
 
 class Parser {
  public:
-  Parser() {
-    std::istringstream input{std::string{kPuzzle8}};
-    numbers_.assign(std::istream_iterator<short>{input}, {});
+  Parser(std::string_view puzzle, std::pmr::memory_resource* resource)
+      : resource_(resource), numbers_(resource) {
+    Scanner scanner{puzzle};
+    while (!scanner.done()) numbers_.push_back(scanner.Int<short>());
   }
 
   Node ParseNode() {
@@ -28,7 +32,7 @@ class Parser {
     short num_children = numbers_[offset_];
     short num_metadata_entries = numbers_[offset_ + 1];
     offset_ += 2;
-    Node output;
+    Node output{resource_};
     output.children.reserve(num_children);
     for (int i = 0; i < num_children; i++)
       output.children.push_back(ParseNode());
@@ -42,12 +46,13 @@ class Parser {
   bool done() { return offset_ == numbers_.size(); }
 
  private:
+  std::pmr::memory_resource* resource_;
   std::size_t offset_ = 0;
-  std::vector<short> numbers_;
+  std::pmr::vector<short> numbers_;
 };
 
-Node GetInput() {
-  Parser parser;
+Node GetInput(std::string_view puzzle, std::pmr::memory_resource* resource) {
+  Parser parser{puzzle, resource};
   Node input = parser.ParseNode();
   assert(parser.done());
   return input;
@@ -74,5 +79,15 @@ int Value(const Node& node) {
 
 }  // namespace
 
-int Solve8A() { return Sum(GetInput()); }
-int Solve8B() { return Value(GetInput()); }
+int Solve8A(std::string_view puzzle) {
+  Arena arena;
+  return Sum(GetInput(puzzle, &arena));
+}
+
+int Solve8B(std::string_view puzzle) {
+  Arena arena;
+  return Value(GetInput(puzzle, &arena));
+}
+
+REGISTER_SOLUTION(Solve8A);
+REGISTER_SOLUTION(Solve8B);
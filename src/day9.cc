@@ -1,23 +1,14 @@
-#include "puzzles.h"
-#include "timing.h"
+#include "registry.h"
+#include "scanner.h"
 
 #include <algorithm>
 #include <cassert>
-#include <cstdlib>
-#include <iostream>
-#include <iterator>
+#include <memory>
+#include <string_view>
 #include <vector>
 
 namespace {
 
-int svtoi(std::string_view input) {
-  const char* begin = input.data();
-  char* end = nullptr;
-  int result = std::strtol(begin, &end, 10);
-  assert(begin != end);
-  return result;
-}
-
 class CircularBuffer {
  public:
   CircularBuffer(int max_size)
@@ -100,24 +91,35 @@ long long Solve(int num_players, int num_marbles) {
   return *i;
 }
 
-}  // namespace
+struct Input { int num_players, last_marble; };
 
-long long Solve9A() {
+Input GetInput(std::string_view puzzle) {
   // N players; last marble is worth M points
-  // ^ num_players                   ^ num_marbles
-  int num_players = svtoi(kPuzzle9);
-  int last_marble = svtoi(kPuzzle9.substr(kPuzzle9.find('h') + 1));
-  assert(0 < num_players);
-  assert(0 < last_marble);
+  // ^ num_players                   ^ last_marble
+  Scanner scanner{puzzle};
+  Input input;
+  input.num_players = scanner.Int();
+  scanner.Expect("players; last marble is worth");
+  input.last_marble = scanner.Int();
+  scanner.Expect("points");
+  assert(0 < input.num_players);
+  assert(0 < input.last_marble);
+  return input;
+}
+
+}  // namespace
+
+long long Solve9A(std::string_view puzzle) {
+  auto [num_players, last_marble] = GetInput(puzzle);
   int num_marbles = 1 + last_marble;  // 0..n inclusive
   return Solve(num_players, num_marbles);
 }
 
-long long Solve9B() {
-  int num_players = svtoi(kPuzzle9);
-  int last_marble = svtoi(kPuzzle9.substr(kPuzzle9.find('h') + 1));
-  assert(0 < num_players);
-  assert(0 < last_marble);
+long long Solve9B(std::string_view puzzle) {
+  auto [num_players, last_marble] = GetInput(puzzle);
   int num_marbles = 1 + 100 * last_marble;
   return Solve(num_players, num_marbles);
 }
+
+REGISTER_SOLUTION(Solve9A);
+REGISTER_SOLUTION(Solve9B);
@@ -0,0 +1,597 @@
+// Driver for main(). Every registered solution is run according to the options
+// given on the command line:
+//
+// ./solve               Run every solution in turn, printing as they finish.
+// ./solve 9B 11 15A     Only run the given days or parts of days.
+// ./solve --filter=R    Only run solutions whose name matches the regex R.
+// ./solve --repeat=N    Run each selected solution N times.
+// ./solve --parallel    Run the solutions on one worker per hardware thread.
+// ./solve --jobs=N      Run the solutions on N workers.
+// ./solve --benchmark   Run each solution repeatedly and report statistics.
+//                       --warmup=N, --time-budget=MS and --max-runs=N control
+//                       how many runs are performed.
+// ./solve --cold        Benchmark each solution as for --benchmark, and again
+//                       with the caches flushed before every run.
+// ./solve --variants    Also run the variants of each selected solution, check
+//                       that they agree with it and benchmark them against
+//                       it.
+// ./solve --allocations Show the allocations made by each solution.
+// ./solve --heap-profile[=BYTES]
+//                       Sample an allocation every BYTES bytes (64KB by
+//                       default) and print the top allocation sites at exit.
+// ./solve --counters    Collect hardware performance counters, if available.
+// ./solve --input=N:F   Use the contents of file F as the input for day N
+//                       instead of the embedded puzzle input.
+// ./solve --stdin 1B   Stream standard input through a solution which can
+//                       read it a line at a time, such as Solve1B_Stream.
+//                       Exactly one such solution must be selected.
+// ./solve --batch=N:P   Run day N on every input in directory P, or on every
+//                       file listed in P, and report the throughput. See
+//                       batch.h.
+// ./solve --format=F    Output a report as text (the default), json or csv.
+// ./solve --compare=R   Compare against a JSON report R from a previous run and
+//                       fail if any answer changed or any solution regressed
+//                       by more than --threshold=PERCENT (10% by default).
+// ./solve --generate=N  Print a synthetic input for day N at --scale=S (1 by
+//                       default) using --seed=X (1 by default).
+// ./solve --scaling     Time each solution on synthetic inputs at scales 1, 2,
+//                       4, ... up to --max-scale=S (16 by default) and report
+//                       how the time grows with the scale.
+// ./solve --hash-benchmark
+//                       Compare FlatHashSet against std::unordered_set on
+//                       keys like those of days 1, 20 and 22. See
+//                       hash_benchmark.h.
+// ./solve --cache=DIR   Reuse answers saved in DIR by an earlier run of the
+//                       same build on the same input, and save new ones there.
+// ./solve --trace=FILE  Record a span for each solution and any phases within
+//                       it, and write them to FILE as a Chrome trace.
+//
+// In every mode the output is printed in order of day and part, so it can be
+// compared directly against golden.txt.
+
+#pragma once
+
+#include "allocation.h"
+#include "batch.h"
+#include "cache.h"
+#include "generators.h"
+#include "hash_benchmark.h"
+#include "mapped_file.h"
+#include "puzzles.h"
+#include "registry.h"
+#include "report.h"
+#include "timing.h"
+#include "trace.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+struct Options {
+  // Number of worker threads. 0 means that the solutions run sequentially on
+  // the main thread.
+  unsigned jobs = 0;
+  bool benchmark = false;
+  // Also benchmark with cold caches.
+  bool cold = false;
+  // Run alternative implementations too, and compare them to the main ones.
+  bool variants = false;
+  bool allocations = false;
+  // Bytes allocated per heap profile sample, or 0 for no heap profile.
+  std::size_t heap_profile = 0;
+  bool counters = false;
+  BenchmarkOptions benchmark_options;
+  Format format = Format::kText;
+  std::optional<std::string_view> compare;
+  double threshold_percent = 10;
+  // inputs[N] is the file to use for day N, if it is not empty.
+  std::array<std::string_view, std::size(kPuzzles)> inputs;
+  // Read the input from standard input, with a streaming solution.
+  bool streaming = false;
+  // Directory or manifest of inputs to solve batch_day for.
+  std::optional<std::string_view> batch;
+  int batch_day = 0;
+  // Days or parts of days to run, such as "9" or "9B". Empty means all.
+  std::vector<std::string_view> selectors;
+  std::optional<std::string_view> filter;
+  int repeat = 1;
+  // Day to print a synthetic input for, instead of running anything.
+  std::optional<int> generate;
+  // Benchmark the hash containers instead of running anything.
+  bool hash_benchmark = false;
+  bool scaling = false;
+  int scale = 1;
+  int max_scale = 16;
+  std::uint64_t seed = 1;
+  // Directory for cached answers. Benchmarks never use the cache.
+  std::optional<std::string_view> cache;
+  // File to write a Chrome trace to.
+  std::optional<std::string_view> trace;
+};
+
+[[noreturn]] inline void Usage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " [DAY[PART]]... [--filter=REGEX] [--repeat=N]"
+               " [--parallel | --jobs=N] [--allocations]"
+               " [--heap-profile[=BYTES]] [--counters]"
+               " [--input=DAY:FILE]... [--stdin] [--batch=DAY:PATH]"
+               " [--benchmark | --cold | --variants [--warmup=N]"
+               " [--time-budget=MS] [--max-runs=N]]"
+               " [--format=text|json|csv]"
+               " [--compare=REPORT [--threshold=PERCENT]]"
+               " [--scaling [--max-scale=N]] [--seed=N] [--cache=DIR]"
+               " [--trace=FILE]\n"
+            << "       " << program
+            << " --generate=DAY [--scale=N] [--seed=N]\n"
+            << "       " << program
+            << " --hash-benchmark [--time-budget=MS] [--max-runs=N]\n";
+  std::exit(1);
+}
+
+// Parse the value of a --flag=N option, which must be a positive integer.
+inline int ParseCount(const char* program, std::string_view value) {
+  int result = 0;
+  for (char c : value) {
+    if (c < '0' || '9' < c) Usage(program);
+    result = 10 * result + (c - '0');
+  }
+  if (value.empty() || result == 0) Usage(program);
+  return result;
+}
+
+// Parse the value of a --flag=X option, which must be a non-negative decimal
+// number such as 0, 5 or 2.5.
+inline double ParseNumber(const char* program, std::string_view value) {
+  double result = 0, scale = 1;
+  bool point = false, digits = false;
+  for (char c : value) {
+    if (c == '.' && !point) {
+      point = true;
+    } else if ('0' <= c && c <= '9') {
+      digits = true;
+      if (point) {
+        scale /= 10;
+        result += scale * (c - '0');
+      } else {
+        result = 10 * result + (c - '0');
+      }
+    } else {
+      Usage(program);
+    }
+  }
+  if (!digits) Usage(program);
+  return result;
+}
+
+// Selectors are a day number optionally followed by a part.
+constexpr bool IsSelector(std::string_view arg) {
+  std::size_t i = 0;
+  while (i < arg.size() && '0' <= arg[i] && arg[i] <= '9') i++;
+  if (i == 0) return false;
+  return i == arg.size() ||
+         (i + 1 == arg.size() && (arg[i] == 'A' || arg[i] == 'B'));
+}
+
+inline bool Matches(const Solution& solution, std::string_view selector) {
+  int day = 0;
+  std::size_t i = 0;
+  for (; i < selector.size() && '0' <= selector[i] && selector[i] <= '9'; i++)
+    day = 10 * day + (selector[i] - '0');
+  return solution.day == day &&
+         (i == selector.size() || selector[i] == solution.part);
+}
+
+inline Options ParseOptions(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string_view arg = argv[i];
+    if (IsSelector(arg)) {
+      options.selectors.push_back(arg);
+    } else if (arg.substr(0, 9) == "--filter=") {
+      options.filter = arg.substr(9);
+    } else if (arg.substr(0, 9) == "--repeat=") {
+      options.repeat = ParseCount(argv[0], arg.substr(9));
+    } else if (arg == "--parallel") {
+      options.jobs = std::max(1u, std::thread::hardware_concurrency());
+    } else if (arg.substr(0, 7) == "--jobs=") {
+      options.jobs = ParseCount(argv[0], arg.substr(7));
+    } else if (arg == "--allocations") {
+      options.allocations = true;
+    } else if (arg == "--heap-profile") {
+      options.heap_profile = 64 << 10;
+    } else if (arg.substr(0, 15) == "--heap-profile=") {
+      options.heap_profile = ParseCount(argv[0], arg.substr(15));
+    } else if (arg == "--counters") {
+      options.counters = true;
+    } else if (arg == "--benchmark") {
+      options.benchmark = true;
+    } else if (arg == "--cold") {
+      options.benchmark = true;
+      options.cold = true;
+    } else if (arg == "--variants") {
+      options.benchmark = true;
+      options.variants = true;
+    } else if (arg.substr(0, 9) == "--warmup=") {
+      // Zero warmup runs is allowed.
+      options.benchmark_options.warmup_runs =
+          arg == "--warmup=0" ? 0 : ParseCount(argv[0], arg.substr(9));
+    } else if (arg.substr(0, 14) == "--time-budget=") {
+      options.benchmark_options.time_budget =
+          std::chrono::milliseconds{ParseCount(argv[0], arg.substr(14))};
+    } else if (arg.substr(0, 11) == "--max-runs=") {
+      options.benchmark_options.max_runs = ParseCount(argv[0], arg.substr(11));
+    } else if (arg == "--format=text") {
+      options.format = Format::kText;
+    } else if (arg == "--format=json") {
+      options.format = Format::kJson;
+    } else if (arg == "--format=csv") {
+      options.format = Format::kCsv;
+    } else if (arg.substr(0, 8) == "--input=") {
+      auto colon = arg.find(':');
+      if (colon == std::string_view::npos) Usage(argv[0]);
+      std::size_t day = ParseCount(argv[0], arg.substr(8, colon - 8));
+      if (day >= options.inputs.size() || colon + 1 == arg.size())
+        Usage(argv[0]);
+      options.inputs[day] = arg.substr(colon + 1);
+    } else if (arg == "--stdin") {
+      options.streaming = true;
+    } else if (arg.substr(0, 8) == "--batch=") {
+      auto colon = arg.find(':');
+      if (colon == std::string_view::npos || colon + 1 == arg.size())
+        Usage(argv[0]);
+      options.batch_day = ParseCount(argv[0], arg.substr(8, colon - 8));
+      options.batch = arg.substr(colon + 1);
+    } else if (arg.substr(0, 10) == "--compare=") {
+      options.compare = arg.substr(10);
+    } else if (arg.substr(0, 12) == "--threshold=") {
+      options.threshold_percent = ParseNumber(argv[0], arg.substr(12));
+    } else if (arg.substr(0, 11) == "--generate=") {
+      options.generate = ParseCount(argv[0], arg.substr(11));
+    } else if (arg == "--hash-benchmark") {
+      options.hash_benchmark = true;
+    } else if (arg == "--scaling") {
+      options.scaling = true;
+    } else if (arg.substr(0, 8) == "--scale=") {
+      options.scale = ParseCount(argv[0], arg.substr(8));
+    } else if (arg.substr(0, 12) == "--max-scale=") {
+      options.max_scale = ParseCount(argv[0], arg.substr(12));
+    } else if (arg.substr(0, 7) == "--seed=") {
+      options.seed = ParseCount(argv[0], arg.substr(7));
+    } else if (arg.substr(0, 8) == "--cache=" && arg.size() > 8) {
+      options.cache = arg.substr(8);
+    } else if (arg.substr(0, 8) == "--trace=" && arg.size() > 8) {
+      options.trace = arg.substr(8);
+    } else {
+      Usage(argv[0]);
+    }
+  }
+  return options;
+}
+
+// The input for each day, which is the embedded puzzle unless --input replaced
+// it. The files stay mapped for as long as the Inputs exist.
+struct Inputs {
+  // puzzles[N] is the input for day N, or empty if there is none.
+  std::array<std::string_view, std::size(kPuzzles)> puzzles;
+  // With --cache, cache_keys[N] is the CacheKey() of puzzles[N].
+  std::array<std::string, std::size(kPuzzles)> cache_keys;
+  std::vector<MappedFile> files;
+};
+
+// Map each input file given on the command line in place of the corresponding
+// puzzle. Returns nullopt if any of the files could not be loaded.
+inline std::optional<Inputs> LoadInputs(const Options& options) {
+  Inputs inputs;
+  for (std::size_t day = 0; day < options.inputs.size(); day++) {
+    if (kPuzzles[day]) inputs.puzzles[day] = *kPuzzles[day];
+    std::string_view path = options.inputs[day];
+    if (path.empty()) continue;
+    if (kPuzzles[day] == nullptr) {
+      std::cerr << "There is no puzzle for day " << day << ".\n";
+      return std::nullopt;
+    }
+    auto file = MappedFile::Open(std::string(path));
+    if (!file) {
+      std::cerr << "Could not load " << path << "\n";
+      return std::nullopt;
+    }
+    inputs.puzzles[day] = file->contents();
+    inputs.files.push_back(std::move(*file));
+  }
+  if (options.cache) {
+    for (std::size_t day = 0; day < inputs.puzzles.size(); day++) {
+      if (kPuzzles[day]) inputs.cache_keys[day] = CacheKey(inputs.puzzles[day]);
+    }
+  }
+  return inputs;
+}
+
+// Run a single solution on its day's input and record the result.
+inline Record Evaluate(const Solution& solution, const Inputs& inputs,
+                       const Options& options) {
+  TraceSpan span{solution.name};
+  const std::string_view puzzle = inputs.puzzles[solution.day];
+  const std::string& cache_key = inputs.cache_keys[solution.day];
+  std::optional<ResultCache> cache;
+  if (options.cache && !options.benchmark) {
+    cache.emplace(*options.cache);
+    // A hit is timed like a run, so that the cost of the lookup is visible.
+    auto start = std::chrono::steady_clock::now();
+    if (auto answer = cache->Lookup(solution, cache_key)) {
+      Record record;
+      record.name = solution.name;
+      record.answer = std::move(*answer);
+      record.time = std::chrono::steady_clock::now() - start;
+      record.cached = true;
+      return record;
+    }
+  }
+  std::optional<PerfCounters> counters;
+  if (options.counters) {
+    // Counters only measure the thread which opened them, so each evaluation
+    // needs its own set.
+    counters.emplace();
+    if (!counters->available()) {
+      static std::atomic<bool> warned = false;
+      if (!warned.exchange(true)) {
+        std::cerr << "Performance counters are unavailable. Check "
+                     "/proc/sys/kernel/perf_event_paranoid.\n";
+      }
+      counters.reset();
+    }
+  }
+  Record record;
+  record.name = solution.name;
+  auto timing = solution.run(puzzle, &record.allocations,
+                             counters ? &*counters : nullptr);
+  record.answer = std::move(timing.value);
+  record.time = timing.time;
+  record.counters = timing.counters;
+  if (options.benchmark) {
+    // The run above already warmed things up.
+    BenchmarkOptions benchmark_options = options.benchmark_options;
+    if (benchmark_options.warmup_runs > 0) benchmark_options.warmup_runs--;
+    auto statistics = solution.benchmark(puzzle, benchmark_options).statistics;
+    record.single_time = record.time;
+    record.time = statistics.median;
+    record.statistics = statistics;
+    if (options.cold) {
+      BenchmarkOptions cold_options = options.benchmark_options;
+      cold_options.cold = true;
+      record.cold_statistics =
+          solution.benchmark(puzzle, cold_options).statistics;
+      if (ImplausibleBenchmark(record.cold_statistics, record.single_time)) {
+        std::cerr << solution.name << ": the cold median of "
+                  << Duration{record.cold_statistics->median}
+                  << " is implausibly far below a single run of "
+                  << Duration{record.single_time} << ".\n";
+      }
+    }
+  }
+  if (cache) cache->Store(solution, cache_key, record.answer);
+  return record;
+}
+
+inline std::vector<Record> RunSequential(
+    const std::vector<Solution>& solutions, const Inputs& inputs,
+    const Options& options, ReportWriter& writer) {
+  std::vector<Record> records;
+  records.reserve(solutions.size());
+  for (const Solution& solution : solutions) {
+    writer.Write(records.emplace_back(Evaluate(solution, inputs, options)));
+    std::cout.flush();
+  }
+  return records;
+}
+
+// Each worker repeatedly claims the next unclaimed solution until there are
+// none left. The results are only printed once every worker is done.
+inline std::vector<Record> RunParallel(const std::vector<Solution>& solutions,
+                                       const Inputs& inputs,
+                                       const Options& options,
+                                       ReportWriter& writer) {
+  std::vector<Record> records(solutions.size());
+  std::atomic<std::size_t> next = 0;
+  auto worker = [&] {
+    while (true) {
+      std::size_t i = next++;
+      if (i >= solutions.size()) return;
+      records[i] = Evaluate(solutions[i], inputs, options);
+    }
+  };
+  std::vector<std::thread> workers;
+  unsigned jobs = std::min<std::size_t>(options.jobs, solutions.size());
+  workers.reserve(jobs);
+  for (unsigned i = 0; i < jobs; i++) workers.emplace_back(worker);
+  for (std::thread& thread : workers) thread.join();
+  for (const Record& record : records) writer.Write(record);
+  return records;
+}
+
+// Pick out the solutions to run, in the order that they should run.
+inline std::vector<Solution> Select(const Options& options,
+                                    const std::vector<Solution>& solutions) {
+  std::optional<std::regex> filter;
+  if (options.filter)
+    filter.emplace(options.filter->begin(), options.filter->end());
+  std::vector<Solution> selected;
+  for (const Solution& solution : solutions) {
+    if (options.streaming) {
+      if (!solution.stream) continue;
+    } else if (!solution.variant.empty() && !options.variants) {
+      continue;
+    }
+    bool matches_selector =
+        options.selectors.empty() ||
+        std::any_of(options.selectors.begin(), options.selectors.end(),
+                    [&](std::string_view selector) {
+                      return Matches(solution, selector);
+                    });
+    bool matches_filter =
+        !filter || std::regex_search(solution.name.begin(),
+                                     solution.name.end(), *filter);
+    if (!matches_selector || !matches_filter) continue;
+    for (int i = 0; i < options.repeat; i++) selected.push_back(solution);
+  }
+  return selected;
+}
+
+// Standard input can only be read once, so only a single solution can run.
+inline int RunStreaming(const Options& options,
+                        const std::vector<Solution>& solutions) {
+  if (solutions.size() != 1) {
+    std::cerr << "--stdin needs exactly one streaming solution, but "
+              << solutions.size() << " were selected.\n";
+    return 1;
+  }
+  const Solution& solution = solutions.front();
+  Record record;
+  record.name = solution.name;
+  auto timing = solution.stream(STDIN_FILENO, &record.allocations);
+  if (!timing) {
+    std::cerr << "\x1b[31mCould not read standard input.\x1b[0m\n";
+    return 1;
+  }
+  record.answer = std::move(timing->value);
+  record.time = timing->time;
+  ReportWriter writer{std::cout, options.format, options.allocations};
+  writer.Write(record);
+  return 0;
+}
+
+// Print a synthetic input for a single day.
+inline int GenerateInput(const Options& options) {
+  const Generator* generator = FindGenerator(*options.generate);
+  if (generator == nullptr) {
+    std::cerr << "There is no generator for day " << *options.generate
+              << ".\n";
+    return 1;
+  }
+  std::cout << generator->generate(options.scale, options.seed);
+  return 0;
+}
+
+// Time a single run, or take the median of a benchmark.
+inline std::chrono::nanoseconds Measure(const Solution& solution,
+                                        std::string_view puzzle,
+                                        const Options& options) {
+  if (options.benchmark) {
+    return solution.benchmark(puzzle, options.benchmark_options)
+        .statistics.median;
+  }
+  AllocationStats allocations;
+  return solution.run(puzzle, &allocations, nullptr).time;
+}
+
+// Fit time = c * scale^k to the measurements by least squares on a log-log
+// scale and return k. Linear solutions give roughly 1 and quadratic ones 2.
+inline double GrowthExponent(const std::vector<std::pair<int, double>>& times) {
+  double n = times.size(), sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+  for (auto [scale, time] : times) {
+    double x = std::log(scale), y = std::log(time);
+    sum_x += x;
+    sum_y += y;
+    sum_xx += x * x;
+    sum_xy += x * y;
+  }
+  return (n * sum_xy - sum_x * sum_y) / (n * sum_xx - sum_x * sum_x);
+}
+
+// Run each solution on synthetic inputs of increasing scale. Days with fixed
+// size inputs are skipped, since their inputs can't grow.
+inline int RunScaling(const Options& options,
+                      const std::vector<Solution>& solutions) {
+  std::cout << std::fixed << std::setprecision(2);
+  for (const Solution& solution : solutions) {
+    const Generator* generator = FindGenerator(solution.day);
+    if (generator == nullptr || !generator->scalable) {
+      std::cerr << "Skipping " << solution.name << ": there is no scalable "
+                << "generator for day " << solution.day << ".\n";
+      continue;
+    }
+    std::cout << solution.name << "\n";
+    std::vector<std::pair<int, double>> times;
+    for (int scale = 1; scale <= options.max_scale; scale *= 2) {
+      const std::string input = generator->generate(scale, options.seed);
+      std::chrono::nanoseconds time = Measure(solution, input, options);
+      std::cout << "  scale " << scale << ": " << Bytes{input.size()}
+                << " input in " << Duration{time};
+      // Clamp to 1ns so that the logarithm is defined.
+      times.emplace_back(scale, std::max<double>(1, time.count()));
+      if (times.size() > 1) {
+        std::cout << ", growth n^"
+                  << GrowthExponent({times.end()[-2], times.back()});
+      }
+      std::cout << std::endl;
+    }
+    if (times.size() > 1)
+      std::cout << "  overall growth n^" << GrowthExponent(times) << "\n";
+  }
+  return 0;
+}
+
+// Returns the exit status for the program.
+inline int RunSolutions(const Options& options,
+                        const std::vector<Solution>& all_solutions) {
+  if (options.generate) return GenerateInput(options);
+  if (options.hash_benchmark)
+    return RunHashBenchmark(options.benchmark_options);
+  auto inputs = LoadInputs(options);
+  if (!inputs) return 1;
+  std::vector<Solution> solutions = Select(options, all_solutions);
+  if (solutions.empty()) {
+    std::cerr << "No solutions were selected.\n";
+    return 1;
+  }
+  if (options.streaming) return RunStreaming(options, solutions);
+  if (options.batch) {
+    return RunBatch(options.batch_day, *options.batch, options.jobs,
+                    solutions);
+  }
+  if (options.scaling) return RunScaling(options, solutions);
+  std::optional<std::unordered_map<std::string, PreviousRecord>> previous;
+  if (options.compare) {
+    previous = ReadReport(*options.compare);
+    if (!previous) {
+      std::cerr << "Could not read report " << *options.compare << "\n";
+      return 1;
+    }
+  }
+  if (options.trace) StartTracing();
+  if (options.heap_profile) StartHeapProfile(options.heap_profile);
+  std::vector<Record> records;
+  {
+    ReportWriter writer{std::cout, options.format, options.allocations};
+    records = options.jobs == 0
+                  ? RunSequential(solutions, *inputs, options, writer)
+                  : RunParallel(solutions, *inputs, options, writer);
+  }
+  if (options.trace) {
+    std::ofstream file{std::string(*options.trace)};
+    WriteTrace(file);
+    StopTracing();
+    if (!file) {
+      std::cerr << "Could not write trace " << *options.trace << "\n";
+      return 1;
+    }
+  }
+  if (previous && !Compare(*previous, records, options.threshold_percent))
+    return 1;
+  if (options.variants && !CompareVariants(records)) return 1;
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include "../puzzles.h"
+#include "registry.h"
+#include "runtime.h"
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+// Solutions release everything they allocate, so after each one the arena is
+// reset to how it was when main() started. The arena is zero-initialized, so
+// pages that are never touched cost nothing. Anything which doesn't fit falls
+// back to malloc().
+constexpr std::size_t kArenaSize = std::size_t{256} << 20;
+alignas(std::max_align_t) char arena[kArenaSize];
+std::size_t arena_used = 0;
+// Allocations below this were made before main(), such as by static
+// initializers, and outlive every solution.
+std::size_t arena_mark = 0;
+
+bool InArena(void* p) {
+  char* c = static_cast<char*>(p);
+  return arena <= c && c < arena + kArenaSize;
+}
+
+constexpr std::size_t RoundUp(std::size_t size) {
+  constexpr std::size_t kAlignment = alignof(std::max_align_t);
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+// Solutions are named like "Solve12B", which is identified by "12B".
+std::string_view Id(const Solution& solution) {
+  return std::string_view{solution.name}.substr(5);
+}
+
+std::pair<int, char> DayAndPart(const Solution& solution) {
+  std::string_view id = Id(solution);
+  int day = 0;
+  std::size_t i = 0;
+  for (; i < id.size() && '0' <= id[i] && id[i] <= '9'; i++)
+    day = 10 * day + (id[i] - '0');
+  return {day, i < id.size() ? id[i] : '?'};
+}
+
+// Variants of a solution, such as "Solve5B_ReactFirst", are only run by solve.
+bool IsVariant(const Solution& solution) {
+  return Id(solution).find('_') != std::string_view::npos;
+}
+
+// Selectors are a day number optionally followed by a part, as for solve.
+bool Matches(const Solution& solution, std::string_view selector) {
+  std::string_view id = Id(solution);
+  if (id == selector) return true;
+  return id.size() == selector.size() + 1 &&
+         id.substr(0, selector.size()) == selector;
+}
+
+}  // namespace
+
+void ResetArena() { arena_used = arena_mark; }
+
+void* operator new(std::size_t size) {
+  size = RoundUp(size);
+  if (size <= kArenaSize - arena_used) {
+    void* p = arena + arena_used;
+    arena_used += size;
+    return p;
+  }
+  void* p = std::malloc(size);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+// Freeing the most recent allocation hands the space back, so short-lived
+// temporaries don't use up the arena. Anything else in the arena is only
+// reclaimed by ResetArena().
+void operator delete(void* p, std::size_t size) noexcept {
+  if (p == nullptr) return;
+  if (!InArena(p)) {
+    std::free(p);
+  } else if (static_cast<char*>(p) + RoundUp(size) == arena + arena_used) {
+    arena_used -= RoundUp(size);
+  }
+}
+
+void operator delete(void* p) noexcept {
+  if (p != nullptr && !InArena(p)) std::free(p);
+}
+
+int main(int argc, char* argv[]) {
+  arena_mark = arena_used;
+  // The registry is scanned once for each day and part in turn, which runs the
+  // solutions in order without collecting them anywhere, so there is no limit
+  // on how many there can be.
+  Writer output{STDOUT_FILENO};
+  for (int day = 0; day < static_cast<int>(std::size(kPuzzles)); day++) {
+    for (char part : {'A', 'B'}) {
+      for (const Registration* i = Registration::head(); i; i = i->next()) {
+        const Solution& solution = i->solution();
+        if (IsVariant(solution) || DayAndPart(solution) != std::pair{day, part})
+          continue;
+        bool selected = argc == 1;
+        for (int j = 1; j < argc && !selected; j++)
+          selected = Matches(solution, argv[j]);
+        if (!selected) continue;
+        output.Write(solution.name);
+        output.Write(": ");
+        solution.run(*kPuzzles[day], output);
+        output.Write("\n");
+        ResetArena();
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+// Registry for the fast runtime, used in place of the main one when building
+// with FAST_RUNTIME. Each solution is reduced to a function which runs it and
+// writes its answer, so nothing here depends on iostreams or on the timing and
+// allocation tracking of the main driver.
+
+#pragma once
+
+#include "../stream.h"
+#include "runtime.h"
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+struct Solution {
+  // The function name, such as "Solve12B".
+  const char* name;
+  void (*run)(std::string_view puzzle, Writer&);
+};
+
+inline void WriteAnswer(Writer& output, const std::string& value) {
+  output.Write(value);
+}
+
+template <typename T>
+void WriteAnswer(Writer& output, T value) {
+  static_assert(std::is_integral_v<T>);
+  output.WriteInt(value);
+}
+
+template <auto* solve>
+void RunAndWrite(std::string_view puzzle, Writer& output) {
+  WriteAnswer(output, solve(puzzle));
+}
+
+// Each registration is a node in an intrusive list of every solution.
+class Registration {
+ public:
+  explicit Registration(Solution solution)
+      : solution_(solution), next_(head_) {
+    head_ = this;
+  }
+
+  Registration(const Registration&) = delete;
+  Registration& operator=(const Registration&) = delete;
+
+  static const Registration* head() { return head_; }
+  const Solution& solution() const { return solution_; }
+  const Registration* next() const { return next_; }
+
+ private:
+  // This is constant-initialized, so it is safe to use from the constructors
+  // of other static objects.
+  static inline const Registration* head_ = nullptr;
+
+  const Solution solution_;
+  const Registration* const next_;
+};
+
+#define REGISTER_SOLUTION(function)                  \
+  static const Registration function##_registration{ \
+      Solution{#function, RunAndWrite<function>}}
+
+// Streaming solutions are variants, which the fast runtime never runs, but
+// they are registered in the same way as in the main registry.
+#define REGISTER_STREAMING_SOLUTION(function)         \
+  static const Registration function##_registration{ \
+      Solution{#function, RunAndWrite<SolveInChunks<function>>}}
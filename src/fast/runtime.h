@@ -0,0 +1,86 @@
+// Minimal runtime for the fast build (./build.sh fast solve_fast), which runs
+// the same solutions as the main driver but with as little as possible around
+// them, so that a single invocation starts and finishes quickly. There are no
+// iostreams, output is collected by a Writer and written with write(), and
+// every allocation comes from a fixed arena which is reset between solutions:
+//
+// Writer output{STDOUT_FILENO};
+// output.Write("Solve1A: ");
+// output.WriteInt(Solve1A(kPuzzle1));
+// output.Write("\n");
+// ResetArena();
+//
+// Inputs are parsed by the solutions themselves with the Scanner from
+// scanner.h, which is already freestanding.
+
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+class Writer {
+ public:
+  explicit Writer(int fd) : fd_(fd) {}
+  ~Writer() { Flush(); }
+
+  Writer(const Writer&) = delete;
+  Writer& operator=(const Writer&) = delete;
+
+  void Write(std::string_view text) {
+    while (!text.empty()) {
+      if (size_ == kBufferSize) Flush();
+      std::size_t n = std::min(text.size(), kBufferSize - size_);
+      text.copy(buffer_ + size_, n);
+      size_ += n;
+      text.remove_prefix(n);
+    }
+  }
+
+  template <typename T>
+  void WriteInt(T value) {
+    static_assert(std::is_integral_v<T>);
+    // Build the number backwards, starting with the least significant digit.
+    // The magnitude is unsigned so that the most negative value works too.
+    using Unsigned = std::make_unsigned_t<T>;
+    Unsigned magnitude = static_cast<Unsigned>(value);
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+      negative = value < 0;
+      if (negative) magnitude = Unsigned{0} - magnitude;
+    }
+    char digits[24];
+    char* begin = digits + sizeof(digits);
+    do {
+      *--begin = '0' + magnitude % 10;
+      magnitude /= 10;
+    } while (magnitude != 0);
+    if (negative) *--begin = '-';
+    Write(std::string_view(begin, digits + sizeof(digits) - begin));
+  }
+
+  void Flush() {
+    const char* data = buffer_;
+    while (size_ > 0) {
+      ssize_t written = write(fd_, data, size_);
+      if (written <= 0) break;
+      data += written;
+      size_ -= written;
+    }
+    size_ = 0;
+  }
+
+ private:
+  static constexpr std::size_t kBufferSize = 64 << 10;
+
+  int fd_;
+  std::size_t size_ = 0;
+  char buffer_[kBufferSize];
+};
+
+// Frees everything allocated from the arena since main() started. Nothing
+// allocated in between may be used afterwards.
+void ResetArena();
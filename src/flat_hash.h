@@ -0,0 +1,260 @@
+// Open-addressing hash set and map which store their elements inline in one
+// flat array, for the lookups in the inner loops of solutions, where the
+// node-based std::unordered_set and std::unordered_map spend most of their
+// time allocating nodes and following pointers:
+//
+// FlatHashSet<Position> visited;
+// if (visited.insert(p).second) ...
+//
+// FlatHashMap<Position, Cell> grid{&arena};
+// grid[p] = Cell::kWall;
+// if (const auto* entry = grid.find(p)) return entry->second;
+//
+// Each slot has a control byte, which is either empty or holds 7 bits of the
+// hash of the key in the slot. A lookup compares the control bytes of a group
+// of 16 slots at once, with SSE2 where the CPU has it, and only compares keys
+// in slots whose byte matches. Groups are probed in triangular order, which
+// visits every group, and the table doubles once it is 7/8 full.
+//
+// Elements can't be erased, so there are no tombstones to probe past, and
+// pointers to elements are invalidated whenever the table grows. The hash
+// must be well mixed in all of its bits, as std::hash<vec2> is. For integers,
+// use MixedHash from hash.h. Memory comes from a std::pmr::memory_resource,
+// so a table can share an Arena with the rest of a solution.
+
+#pragma once
+
+#include "hash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace flat_hash_internal {
+
+constexpr std::size_t kGroupSize = 16;
+// Full slots hold 7 bits of the hash, so their top bit is clear.
+constexpr std::int8_t kEmpty = -128;
+
+// Bit i is set if control[i] == byte, for each of the group's slots.
+inline std::uint32_t MatchByte(const std::int8_t* control, std::int8_t byte) {
+#ifdef __SSE2__
+  __m128i group = _mm_load_si128(reinterpret_cast<const __m128i*>(control));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(byte)));
+#else
+  std::uint32_t mask = 0;
+  for (std::size_t i = 0; i < kGroupSize; i++)
+    mask |= std::uint32_t{control[i] == byte} << i;
+  return mask;
+#endif
+}
+
+// The table shared by FlatHashSet and FlatHashMap. Each slot holds a Slot,
+// whose key is found with GetKey.
+template <typename Key, typename Slot, typename Hash, typename GetKey>
+class Table {
+ public:
+  explicit Table(std::pmr::memory_resource* resource =
+                     std::pmr::get_default_resource())
+      : resource_(resource) {}
+
+  ~Table() { Deallocate(); }
+
+  Table(const Table&) = delete;
+  Table& operator=(const Table&) = delete;
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  std::size_t capacity() const { return num_groups_ * kGroupSize; }
+  std::pmr::memory_resource* resource() const { return resource_; }
+
+  // Grows the table so that it can hold n elements without growing again.
+  void reserve(std::size_t n) {
+    std::size_t num_groups = num_groups_ == 0 ? 1 : num_groups_;
+    while (MaxLoad(num_groups) < n) num_groups *= 2;
+    if (num_groups != num_groups_) Rehash(num_groups);
+  }
+
+  Slot* find(const Key& key) {
+    return const_cast<Slot*>(std::as_const(*this).find(key));
+  }
+
+  const Slot* find(const Key& key) const {
+    if (size_ == 0) return nullptr;
+    const std::size_t hash = Hash{}(key);
+    const std::int8_t tag = Tag(hash);
+    std::size_t group = FirstGroup(hash);
+    for (std::size_t step = 1;; step++) {
+      const std::int8_t* control = control_ + group * kGroupSize;
+      for (std::uint32_t mask = MatchByte(control, tag); mask;
+           mask &= mask - 1) {
+        const Slot& slot = slots_[group * kGroupSize + __builtin_ctz(mask)];
+        if (GetKey{}(slot) == key) return &slot;
+      }
+      if (MatchByte(control, kEmpty)) return nullptr;
+      group = (group + step) & (num_groups_ - 1);
+    }
+  }
+
+  std::size_t count(const Key& key) const { return find(key) ? 1 : 0; }
+
+  // The number of groups that a lookup of key examines, which is 1 unless
+  // its first group was full.
+  std::size_t ProbeLength(const Key& key) const {
+    if (num_groups_ == 0) return 0;
+    const std::size_t hash = Hash{}(key);
+    const std::int8_t tag = Tag(hash);
+    std::size_t group = FirstGroup(hash);
+    for (std::size_t step = 1;; step++) {
+      const std::int8_t* control = control_ + group * kGroupSize;
+      for (std::uint32_t mask = MatchByte(control, tag); mask;
+           mask &= mask - 1) {
+        const Slot& slot = slots_[group * kGroupSize + __builtin_ctz(mask)];
+        if (GetKey{}(slot) == key) return step;
+      }
+      if (MatchByte(control, kEmpty)) return step;
+      group = (group + step) & (num_groups_ - 1);
+    }
+  }
+
+ protected:
+  // Returns the slot holding key, constructing it from args if there was none,
+  // and whether it was constructed.
+  template <typename... Args>
+  std::pair<Slot*, bool> Emplace(const Key& key, Args&&... args) {
+    if (Slot* slot = find(key)) return {slot, false};
+    if (size_ + 1 > MaxLoad(num_groups_))
+      Rehash(num_groups_ == 0 ? 1 : 2 * num_groups_);
+    Slot* slot = Claim(Hash{}(key));
+    new (slot) Slot(std::forward<Args>(args)...);
+    size_++;
+    return {slot, true};
+  }
+
+ private:
+  // The low bits of the hash pick the group and the high bits are the tag, so
+  // that keys in the same group rarely share a tag.
+  static std::int8_t Tag(std::size_t hash) { return hash >> 57; }
+  std::size_t FirstGroup(std::size_t hash) const {
+    return hash & (num_groups_ - 1);
+  }
+
+  static constexpr std::size_t MaxLoad(std::size_t num_groups) {
+    return num_groups * kGroupSize / 8 * 7;
+  }
+
+  // Marks the first empty slot on the probe sequence for hash as full and
+  // returns it, leaving it to the caller to construct the element.
+  Slot* Claim(std::size_t hash) {
+    std::size_t group = FirstGroup(hash);
+    for (std::size_t step = 1;; step++) {
+      std::int8_t* control = control_ + group * kGroupSize;
+      if (std::uint32_t empty = MatchByte(control, kEmpty)) {
+        std::size_t i = __builtin_ctz(empty);
+        control[i] = Tag(hash);
+        return &slots_[group * kGroupSize + i];
+      }
+      group = (group + step) & (num_groups_ - 1);
+    }
+  }
+
+  void Rehash(std::size_t num_groups) {
+    std::int8_t* old_control = control_;
+    Slot* old_slots = slots_;
+    const std::size_t old_capacity = capacity();
+    num_groups_ = num_groups;
+    control_ = static_cast<std::int8_t*>(
+        resource_->allocate(capacity(), kGroupSize));
+    slots_ = static_cast<Slot*>(
+        resource_->allocate(capacity() * sizeof(Slot), alignof(Slot)));
+    std::memset(control_, kEmpty, capacity());
+    for (std::size_t i = 0; i < old_capacity; i++) {
+      if (old_control[i] == kEmpty) continue;
+      Slot& slot = old_slots[i];
+      new (Claim(Hash{}(GetKey{}(slot)))) Slot(std::move(slot));
+      slot.~Slot();
+    }
+    if (old_capacity > 0) {
+      resource_->deallocate(old_control, old_capacity, kGroupSize);
+      resource_->deallocate(old_slots, old_capacity * sizeof(Slot),
+                            alignof(Slot));
+    }
+  }
+
+  void Deallocate() {
+    if (num_groups_ == 0) return;
+    if constexpr (!std::is_trivially_destructible_v<Slot>) {
+      for (std::size_t i = 0; i < capacity(); i++) {
+        if (control_[i] != kEmpty) slots_[i].~Slot();
+      }
+    }
+    resource_->deallocate(control_, capacity(), kGroupSize);
+    resource_->deallocate(slots_, capacity() * sizeof(Slot), alignof(Slot));
+  }
+
+  std::pmr::memory_resource* resource_;
+  // A power of two, or 0 before anything is inserted.
+  std::size_t num_groups_ = 0;
+  std::size_t size_ = 0;
+  std::int8_t* control_ = nullptr;
+  Slot* slots_ = nullptr;
+};
+
+struct SetKey {
+  template <typename Key>
+  const Key& operator()(const Key& key) const {
+    return key;
+  }
+};
+
+struct MapKey {
+  template <typename Key, typename Value>
+  const Key& operator()(const std::pair<Key, Value>& entry) const {
+    return entry.first;
+  }
+};
+
+}  // namespace flat_hash_internal
+
+template <typename Key, typename Hash = std::hash<Key>>
+class FlatHashSet
+    : public flat_hash_internal::Table<Key, Key, Hash,
+                                       flat_hash_internal::SetKey> {
+ public:
+  using flat_hash_internal::Table<Key, Key, Hash,
+                                  flat_hash_internal::SetKey>::Table;
+
+  std::pair<const Key*, bool> insert(const Key& key) {
+    return this->Emplace(key, key);
+  }
+};
+
+// Entries are std::pair<Key, Value>. The key must not be modified.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap
+    : public flat_hash_internal::Table<Key, std::pair<Key, Value>, Hash,
+                                       flat_hash_internal::MapKey> {
+ public:
+  using flat_hash_internal::Table<Key, std::pair<Key, Value>, Hash,
+                                  flat_hash_internal::MapKey>::Table;
+
+  template <typename... Args>
+  std::pair<std::pair<Key, Value>*, bool> try_emplace(const Key& key,
+                                                      Args&&... args) {
+    return this->Emplace(key, std::piecewise_construct,
+                         std::forward_as_tuple(key),
+                         std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  Value& operator[](const Key& key) { return try_emplace(key).first->second; }
+};
@@ -0,0 +1,577 @@
+#include "generators.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// The engines and distributions in <random> are not guaranteed to produce the
+// same sequence with every standard library, so this uses splitmix64 to make
+// sure that a seed always produces the same input.
+class Random {
+ public:
+  explicit Random(std::uint64_t seed) : state_(seed) {}
+
+  std::uint64_t Next() {
+    std::uint64_t z = (state_ += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  // Uniformly distributed in [min, max].
+  int Uniform(int min, int max) {
+    return min + static_cast<int>(Next() % (max - min + 1));
+  }
+
+  // True with probability numerator / denominator.
+  bool Chance(int numerator, int denominator) {
+    return Uniform(1, denominator) <= numerator;
+  }
+
+  template <typename T>
+  void Shuffle(std::vector<T>& values) {
+    for (std::size_t i = values.size(); i > 1; i--)
+      std::swap(values[i - 1], values[Next() % i]);
+  }
+
+ private:
+  std::uint64_t state_;
+};
+
+// Shuffles the lines of an input whose lines can appear in any order.
+std::string ShuffledLines(std::vector<std::string> lines, Random& random) {
+  random.Shuffle(lines);
+  std::string output;
+  for (const std::string& line : lines) output += line + "\n";
+  return output;
+}
+
+// Scale: 1000 frequency changes per unit. The changes sum to one, so every
+// frequency from the first pass is revisited in a later pass and part B always
+// finds a repeat.
+std::string Generate1(int scale, std::uint64_t seed) {
+  Random random{seed};
+  int n = 1000 * scale;
+  std::ostringstream output;
+  int sum = 0;
+  for (int i = 0; i < n; i++) {
+    int delta = i + 1 < n ? random.Uniform(1, 20) : 1 - sum;
+    if (i + 1 < n && random.Chance(1, 2)) delta = -delta;
+    sum += delta;
+    output << (delta < 0 ? "" : "+") << delta << "\n";
+  }
+  return output.str();
+}
+
+// Scale: 250 box IDs per unit. Exactly one pair of IDs differs by one letter,
+// and the second of them is last so that part B has to search everything.
+std::string Generate2(int scale, std::uint64_t seed) {
+  Random random{seed};
+  std::vector<std::string> ids(250 * scale, std::string(26, 'a'));
+  for (std::string& id : ids) {
+    for (char& c : id) c = 'a' + random.Uniform(0, 25);
+  }
+  std::string& copy = ids.back();
+  copy = ids[random.Uniform(0, ids.size() - 2)];
+  char& changed = copy[random.Uniform(0, 25)];
+  changed = 'a' + (changed - 'a' + random.Uniform(1, 25)) % 26;
+  std::string output;
+  for (const std::string& id : ids) output += id + "\n";
+  return output;
+}
+
+// Scale: 1300 claims per unit, on the same 1000x1000 fabric. The last claim is
+// kept apart from the others so that part B has an answer.
+std::string Generate3(int scale, std::uint64_t seed) {
+  Random random{seed};
+  int n = 1300 * scale;
+  std::ostringstream output;
+  for (int i = 0; i < n; i++) {
+    int width = random.Uniform(10, 19), height = random.Uniform(10, 29);
+    int x = i == n - 1 ? random.Uniform(965, 980)
+                       : random.Uniform(0, 960 - width);
+    int y = random.Uniform(0, 1000 - height);
+    output << "#" << i + 1 << " @ " << x << "," << y << ": " << width << "x"
+           << height << "\n";
+  }
+  return output.str();
+}
+
+// Scale: 500 shifts and 20 guards per unit, so that each guard works a similar
+// number of shifts at any scale. The log is shuffled, as in the puzzle.
+std::string Generate4(int scale, std::uint64_t seed) {
+  Random random{seed};
+  std::vector<int> guards(30 * scale);
+  std::iota(guards.begin(), guards.end(), 10);
+  random.Shuffle(guards);
+  guards.resize(20 * scale);
+  std::vector<std::string> lines;
+  for (int shift = 0, n = 500 * scale; shift < n; shift++) {
+    auto entry = [&](int minute) {
+      std::ostringstream line;
+      line << std::setfill('0') << "[" << 1518 + shift / 336 << "-"
+           << std::setw(2) << shift / 28 % 12 + 1 << "-" << std::setw(2)
+           << shift % 28 + 1 << " 00:" << std::setw(2) << minute << "] ";
+      return line.str();
+    };
+    int start = random.Uniform(0, 5);
+    int guard = guards[random.Uniform(0, guards.size() - 1)];
+    lines.push_back(entry(start) + "Guard #" + std::to_string(guard) +
+                    " begins shift");
+    // Pick an even number of distinct minutes which alternate between falling
+    // asleep and waking up.
+    std::set<int> minutes;
+    int naps = random.Uniform(0, 3);
+    while (static_cast<int>(minutes.size()) < 2 * naps)
+      minutes.insert(random.Uniform(start + 1, 59));
+    bool asleep = false;
+    for (int minute : minutes) {
+      asleep = !asleep;
+      lines.push_back(entry(minute) + (asleep ? "falls asleep" : "wakes up"));
+    }
+  }
+  return ShuffledLines(std::move(lines), random);
+}
+
+// Scale: 50000 units of polymer per unit. Roughly a third of the units are
+// followed by their opposite so that there is plenty to react.
+std::string Generate5(int scale, std::uint64_t seed) {
+  Random random{seed};
+  std::string output;
+  for (int i = 0, n = 50000 * scale; i < n; i++) {
+    if (!output.empty() && random.Chance(1, 3)) {
+      output.push_back(output.back() ^ ('a' - 'A'));
+    } else {
+      char base = random.Chance(1, 2) ? 'a' : 'A';
+      output.push_back(base + random.Uniform(0, 25));
+    }
+  }
+  return output + "\n";
+}
+
+// Scale: the area of the region containing the 50 coordinates. The number of
+// coordinates is limited by the solution.
+std::string Generate6(int scale, std::uint64_t seed) {
+  Random random{seed};
+  int size = static_cast<int>(std::lround(300 * std::sqrt(scale)));
+  std::set<std::pair<int, int>> coordinates;
+  std::ostringstream output;
+  while (coordinates.size() < 50) {
+    int x = 40 + random.Uniform(0, size), y = 40 + random.Uniform(0, size);
+    if (coordinates.emplace(x, y).second) output << x << ", " << y << "\n";
+  }
+  return output.str();
+}
+
+// Fixed size: there are only 26 steps.
+std::string Generate7(int, std::uint64_t seed) {
+  Random random{seed};
+  // Dependencies always point forwards in this order, so there are no cycles.
+  std::vector<char> order(26);
+  std::iota(order.begin(), order.end(), 'A');
+  random.Shuffle(order);
+  std::set<std::pair<int, int>> dependencies;
+  while (dependencies.size() < 100) {
+    int before = random.Uniform(0, 24);
+    dependencies.emplace(before, random.Uniform(before + 1, 25));
+  }
+  std::vector<std::string> lines;
+  for (auto [before, after] : dependencies) {
+    lines.push_back(std::string("Step ") + order[before] +
+                    " must be finished before step " + order[after] +
+                    " can begin.");
+  }
+  return ShuffledLines(std::move(lines), random);
+}
+
+// Writes a tree of exactly `size` nodes. The nodes are spread randomly between
+// the children, which keeps the tree shallow.
+void GenerateNode(int size, Random& random, std::ostream& output) {
+  int num_children = size == 1 ? 0 : random.Uniform(1, std::min(5, size - 1));
+  int num_metadata = random.Uniform(1, 11);
+  output << num_children << " " << num_metadata;
+  std::vector<int> child_sizes(num_children, 1);
+  for (int i = num_children; i < size - 1; i++)
+    child_sizes[random.Uniform(0, num_children - 1)]++;
+  for (int child_size : child_sizes) {
+    output << " ";
+    GenerateNode(child_size, random, output);
+  }
+  for (int i = 0; i < num_metadata; i++) {
+    // Metadata for a node with children are mostly valid child indices.
+    int max = num_children == 0 ? 9 : num_children + 1;
+    output << " " << random.Uniform(1, max);
+  }
+}
+
+// Scale: 2000 nodes per unit.
+std::string Generate8(int scale, std::uint64_t seed) {
+  Random random{seed};
+  std::ostringstream output;
+  GenerateNode(2000 * scale, random, output);
+  output << "\n";
+  return output.str();
+}
+
+// Scale: 10000 marbles per unit.
+std::string Generate9(int scale, std::uint64_t seed) {
+  Random random{seed};
+  std::ostringstream output;
+  output << random.Uniform(10, 500) << " players; last marble is worth "
+         << 10000 * scale + random.Uniform(0, 999) << " points\n";
+  return output.str();
+}
+
+// Scale: 350 points per unit. Every point passes through a 60x10 box at the
+// same moment. Points which sit on opposite corners of the box and move in
+// both directions make the box strictly smallest at that moment.
+std::string Generate10(int scale, std::uint64_t seed) {
+  Random random{seed};
+  int time = random.Uniform(10000, 11000);
+  std::ostringstream output;
+  auto add = [&](int x, int y, int dx, int dy) {
+    output << "position=<" << std::setw(6) << x - dx * time << ", "
+           << std::setw(6) << y - dy * time << "> velocity=<" << std::setw(2)
+           << dx << ", " << std::setw(2) << dy << ">\n";
+  };
+  for (int i = 0, n = 350 * scale; i < n; i++) {
+    add(random.Uniform(0, 59), random.Uniform(0, 9), random.Uniform(-5, 5),
+        random.Uniform(-5, 5));
+  }
+  for (int direction : {-1, 1}) {
+    add(0, 0, direction, direction);
+    add(59, 9, direction, direction);
+  }
+  return output.str();
+}
+
+// Fixed size: the grid is always 300x300.
+std::string Generate11(int, std::uint64_t seed) {
+  Random random{seed};
+  return std::to_string(random.Uniform(1000, 9999)) + "\n";
+}
+
+// Fixed size: the solution expects exactly 99 pots. The rules move every plant
+// one pot in the same direction, which guarantees that part B converges.
+std::string Generate12(int, std::uint64_t seed) {
+  Random random{seed};
+  std::string pots(99, '.');
+  for (char& pot : pots) pot = random.Chance(1, 2) ? '#' : '.';
+  pots[random.Uniform(0, 98)] = '#';
+  int source = random.Chance(1, 2) ? 1 : 3;
+  std::vector<std::string> rules;
+  for (int key = 0; key < 32; key++) {
+    std::string rule = "..... => .";
+    for (int i = 0; i < 5; i++) {
+      if (key >> i & 1) rule[i] = '#';
+    }
+    rule[9] = rule[source];
+    rules.push_back(rule);
+  }
+  return "initial state: " + pots + "\n\n" +
+         ShuffledLines(std::move(rules), random);
+}
+
+// Fixed size: the solution expects a 150x150 grid. Each track is a separate
+// loop. Every loop but one has a pair of carts going in opposite directions,
+// which must collide, and the remaining loop has a single cart that survives.
+std::string Generate13(int, std::uint64_t seed) {
+  Random random{seed};
+  constexpr int kSize = 150, kTile = 30;
+  std::vector<std::string> grid(kSize, std::string(kSize, ' '));
+  std::vector<std::array<int, 4>> loops;
+  constexpr int kTilesPerRow = kSize / kTile;
+  for (int tile = 0; tile < kTilesPerRow * kTilesPerRow; tile++) {
+    if (tile >= 2 && random.Chance(1, 4)) continue;
+    int left = tile % kTilesPerRow * kTile, top = tile / kTilesPerRow * kTile;
+    int x0 = left + random.Uniform(0, 5);
+    int x1 = left + kTile - 1 - random.Uniform(0, 5);
+    int y0 = top + random.Uniform(0, 5);
+    int y1 = top + kTile - 1 - random.Uniform(0, 5);
+    for (int x = x0 + 1; x < x1; x++) grid[y0][x] = grid[y1][x] = '-';
+    for (int y = y0 + 1; y < y1; y++) grid[y][x0] = grid[y][x1] = '|';
+    grid[y0][x0] = grid[y1][x1] = '/';
+    grid[y0][x1] = grid[y1][x0] = '\\';
+    loops.push_back({x0, y0, x1, y1});
+  }
+  std::size_t lone = random.Uniform(0, loops.size() - 1);
+  for (std::size_t i = 0; i < loops.size(); i++) {
+    auto [x0, y0, x1, y1] = loops[i];
+    // Moving right on the top edge is clockwise, and on the bottom edge it is
+    // counterclockwise.
+    grid[y0][random.Uniform(x0 + 1, x1 - 1)] = '>';
+    if (i != lone) grid[y1][random.Uniform(x0 + 1, x1 - 1)] = '>';
+  }
+  std::string output;
+  for (const std::string& row : grid) output += row + "\n";
+  return output;
+}
+
+// Scale: part A makes roughly 100000 recipes per unit and part B searches
+// roughly ten times as many. The input is taken from the sequence of recipes so
+// that part B always finds it.
+std::string Generate14(int scale, std::uint64_t seed) {
+  Random random{seed};
+  std::string target = std::to_string(100000 * scale);
+  std::size_t start = random.Uniform(900000, 1100000) * std::size_t(scale);
+  std::string recipes = "37";
+  std::size_t elves[2] = {0, 1};
+  while (true) {
+    int score = (recipes[elves[0]] - '0') + (recipes[elves[1]] - '0');
+    if (score >= 10) recipes.push_back('1');
+    recipes.push_back('0' + score % 10);
+    for (std::size_t& elf : elves)
+      elf = (elf + 1 + recipes[elf] - '0') % recipes.size();
+    // Take the first window which is close to the target number.
+    std::size_t n = recipes.size();
+    if (n < start + target.size()) continue;
+    std::string window = recipes.substr(n - target.size(), target.size());
+    if (window[0] == target[0] && window[1] >= target[1] &&
+        window[1] <= target[1] + 1) {
+      return window + "\n";
+    }
+  }
+}
+
+// Fixed size: the solution expects a 32x32 cave. Squares that can't be reached
+// are filled in so that the two sides can always meet.
+std::string Generate15(int, std::uint64_t seed) {
+  Random random{seed};
+  constexpr int kSize = 32;
+  std::vector<std::string> grid(kSize, std::string(kSize, '#'));
+  for (int y = 1; y < kSize - 1; y++) {
+    for (int x = 1; x < kSize - 1; x++)
+      grid[y][x] = random.Chance(1, 5) ? '#' : '.';
+  }
+  // Flood fill from the middle, marking reachable squares with '?'.
+  std::vector<std::pair<int, int>> frontier = {{kSize / 2, kSize / 2}};
+  grid[kSize / 2][kSize / 2] = '?';
+  std::vector<std::pair<int, int>> open;
+  while (!frontier.empty()) {
+    auto [x, y] = frontier.back();
+    frontier.pop_back();
+    open.emplace_back(x, y);
+    for (auto [dx, dy] : {std::pair{0, -1}, {-1, 0}, {1, 0}, {0, 1}}) {
+      char& cell = grid[y + dy][x + dx];
+      if (cell != '.') continue;
+      cell = '?';
+      frontier.emplace_back(x + dx, y + dy);
+    }
+  }
+  for (std::string& row : grid) {
+    for (char& cell : row) cell = cell == '?' ? '.' : '#';
+  }
+  random.Shuffle(open);
+  int elves = random.Uniform(5, 10), goblins = random.Uniform(10, 20);
+  open.resize(std::min<std::size_t>(open.size(), elves + goblins));
+  for (std::size_t i = 0; i < open.size(); i++) {
+    auto [x, y] = open[i];
+    grid[y][x] = static_cast<int>(i) < elves ? 'E' : 'G';
+  }
+  std::string output;
+  for (const std::string& row : grid) output += row + "\n";
+  return output;
+}
+
+// Opcodes for day 16, in any order.
+int Execute(int op, int a, int b, const std::array<int, 4>& r) {
+  switch (op) {
+    case 0: return r[a] + r[b];
+    case 1: return r[a] + b;
+    case 2: return r[a] * r[b];
+    case 3: return r[a] * b;
+    case 4: return r[a] & r[b];
+    case 5: return r[a] & b;
+    case 6: return r[a] | r[b];
+    case 7: return r[a] | b;
+    case 8: return r[a];
+    case 9: return a;
+    case 10: return a > r[b];
+    case 11: return r[a] > b;
+    case 12: return r[a] > r[b];
+    case 13: return a == r[b];
+    case 14: return r[a] == b;
+    default: return r[a] == r[b];
+  }
+}
+
+// Scale: 800 samples and 1000 instructions per unit. Sample registers stay in
+// [0, 4), and program registers stay within the 16-bit range of the solution.
+std::string Generate16(int scale, std::uint64_t seed) {
+  Random random{seed};
+  std::vector<int> codes(16);
+  std::iota(codes.begin(), codes.end(), 0);
+  random.Shuffle(codes);
+  std::ostringstream output;
+  auto write = [&](const char* label, const std::array<int, 4>& r) {
+    output << label << "[" << r[0] << ", " << r[1] << ", " << r[2] << ", "
+           << r[3] << "]\n";
+  };
+  for (int i = 0, n = 800 * scale; i < n;) {
+    std::array<int, 4> before;
+    for (int& x : before) x = random.Uniform(0, 3);
+    int op = random.Uniform(0, 15), a = random.Uniform(0, 3),
+        b = random.Uniform(0, 3), c = random.Uniform(0, 3);
+    std::array<int, 4> after = before;
+    after[c] = Execute(op, a, b, before);
+    if (after[c] > 3) continue;
+    write("Before: ", before);
+    output << codes[op] << " " << a << " " << b << " " << c << "\n";
+    write("After:  ", after);
+    output << "\n";
+    i++;
+  }
+  output << "\n\n";
+  std::array<int, 4> registers = {};
+  for (int i = 0, n = 1000 * scale; i < n;) {
+    int op = random.Uniform(0, 15), a = random.Uniform(0, 3),
+        b = random.Uniform(0, 3), c = random.Uniform(0, 3);
+    int result = Execute(op, a, b, registers);
+    if (result < -32768 || 32767 < result) continue;
+    registers[c] = result;
+    output << codes[op] << " " << a << " " << b << " " << c << "\n";
+    i++;
+  }
+  return output.str();
+}
+
+// Scale: the width of the scan, up to the limit of the solution. There is
+// roughly one reservoir per thousand squares.
+std::string Generate17(int scale, std::uint64_t seed) {
+  Random random{seed};
+  int width = std::min(1900, 200 * scale);
+  int left = std::max(10, 500 - width / 2);
+  std::vector<std::string> lines;
+  auto vertical = [&](int x, int y_min, int y_max) {
+    lines.push_back("x=" + std::to_string(x) + ", y=" + std::to_string(y_min) +
+                    ".." + std::to_string(y_max));
+  };
+  // Keep clay away from the spring, which sits on the top row.
+  vertical(left, 1, 2);
+  for (int i = 0, n = width * 1800 / 1000; i < n; i++) {
+    int x_min = left + random.Uniform(0, width - 25);
+    int x_max = x_min + random.Uniform(2, 24);
+    int bottom = random.Uniform(20, 1900);
+    vertical(x_min, bottom - random.Uniform(2, 15), bottom);
+    vertical(x_max, bottom - random.Uniform(2, 15), bottom);
+    lines.push_back("y=" + std::to_string(bottom) + ", x=" +
+                    std::to_string(x_min) + ".." + std::to_string(x_max));
+  }
+  return ShuffledLines(std::move(lines), random);
+}
+
+// Fixed size: the solution expects a 50x50 area.
+std::string Generate18(int, std::uint64_t seed) {
+  Random random{seed};
+  std::string output;
+  for (int y = 0; y < 50; y++) {
+    for (int x = 0; x < 50; x++) {
+      int roll = random.Uniform(0, 7);
+      output.push_back(roll < 4 ? '.' : roll < 6 ? '|' : '#');
+    }
+    output.push_back('\n');
+  }
+  return output;
+}
+
+char Opposite(char direction) {
+  switch (direction) {
+    case 'N': return 'S';
+    case 'E': return 'W';
+    case 'S': return 'N';
+    default: return 'E';
+  }
+}
+
+// Writes a path of roughly `size` characters. As in the puzzle, branches only
+// appear at the end of a path, and any other options are detours which return
+// to where they started, so the number of positions being tracked stays small.
+void GeneratePath(int size, Random& random, std::string& output) {
+  constexpr char kDirections[] = "NESW";
+  while (size > 0) {
+    for (int i = 0, n = random.Uniform(1, 8); i < n; i++)
+      output.push_back(kDirections[random.Uniform(0, 3)]);
+    size -= 8;
+    if (random.Chance(1, 4)) {
+      std::string detour;
+      for (int i = 0, n = random.Uniform(1, 4); i < n; i++)
+        detour.push_back(kDirections[random.Uniform(0, 3)]);
+      output += "(" + detour;
+      for (auto i = detour.rbegin(); i != detour.rend(); i++)
+        output.push_back(Opposite(*i));
+      output += "|)";
+      size -= 4 * detour.size();
+    }
+    if (size > 20 && random.Chance(1, 6)) {
+      int options = random.Uniform(2, 3);
+      output.push_back('(');
+      for (int i = 0; i < options; i++) {
+        if (i > 0) output.push_back('|');
+        GeneratePath(size / options, random, output);
+      }
+      output.push_back(')');
+      return;
+    }
+  }
+}
+
+// Scale: 14000 characters of pattern per unit.
+std::string Generate20(int scale, std::uint64_t seed) {
+  Random random{seed};
+  std::string output = "^";
+  GeneratePath(14000 * scale, random, output);
+  return output + "$\n";
+}
+
+// Scale: the area which part B searches. Part A covers the rectangle up to the
+// target, which grows with the square root of the scale.
+std::string Generate22(int scale, std::uint64_t seed) {
+  Random random{seed};
+  std::ostringstream output;
+  output << "depth: " << random.Uniform(3000, 12000) << "\n"
+         << "target: " << random.Uniform(5, 15) << ","
+         << std::lround(750 * std::sqrt(scale)) << "\n";
+  return output.str();
+}
+
+// Scale: 1000 nanobots per unit.
+std::string Generate23(int scale, std::uint64_t seed) {
+  Random random{seed};
+  std::ostringstream output;
+  for (int i = 0, n = 1000 * scale; i < n; i++) {
+    output << "pos=<" << random.Uniform(-60'000'000, 60'000'000) << ","
+           << random.Uniform(-60'000'000, 60'000'000) << ","
+           << random.Uniform(-60'000'000, 60'000'000)
+           << ">, r=" << random.Uniform(50'000'000, 100'000'000) << "\n";
+  }
+  return output.str();
+}
+
+constexpr Generator kGenerators[] = {
+    {1, true, Generate1},     {2, true, Generate2},   {3, true, Generate3},
+    {4, true, Generate4},     {5, true, Generate5},   {6, true, Generate6},
+    {7, false, Generate7},    {8, true, Generate8},   {9, true, Generate9},
+    {10, true, Generate10},   {11, false, Generate11}, {12, false, Generate12},
+    {13, false, Generate13},  {14, true, Generate14}, {15, false, Generate15},
+    {16, true, Generate16},   {17, true, Generate17}, {18, false, Generate18},
+    {20, true, Generate20},   {22, true, Generate22}, {23, true, Generate23},
+};
+
+}  // namespace
+
+const Generator* FindGenerator(int day) {
+  for (const Generator& generator : kGenerators) {
+    if (generator.day == day) return &generator;
+  }
+  return nullptr;
+}
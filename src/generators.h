@@ -0,0 +1,21 @@
+// Synthetic input generators. Each day has a generator which produces a valid
+// input in the same format as puzzles/N.txt, determined entirely by a seed and
+// a scale factor. For most days the scale factor multiplies the size of the
+// problem, as described alongside each generator, so that the solutions can be
+// timed across a range of sizes. Some puzzles have a fixed size, and their
+// generators ignore the scale factor.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+struct Generator {
+  int day;
+  // False if the generator ignores the scale factor.
+  bool scalable;
+  std::string (*generate)(int scale, std::uint64_t seed);
+};
+
+// Returns nullptr if there is no generator for the given day.
+const Generator* FindGenerator(int day);
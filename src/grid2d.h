@@ -0,0 +1,244 @@
+// Dense two-dimensional grid, for the solutions which simulate or search a map.
+// Cells are addressed as (x, y), for 0 <= x < width and 0 <= y < height, and
+// the grid can be surrounded by a border of sentinel cells, so that reading the
+// neighbours of any cell, including those on the edge, needs no bounds checks:
+//
+// // Anything beyond the edge of the map reads as open ground.
+// Grid2D<Cell> grid{50, 50, Cell::kOpen, 1, Cell::kOpen};
+// for (int y = 0; y < grid.height(); y++) {
+//   for (int x = 0; x < grid.width(); x++) {
+//     for (Cell neighbour : grid.Neighbours8(x, y)) ...
+//   }
+// }
+// int trees = grid.Count(Cell::kTrees);
+//
+// Iteration, over the whole grid or over a single Row(), is in reading order
+// and skips the border. Neighbours are also listed in reading order.
+//
+// How cells are arranged in memory is chosen by the Layout parameter, so that
+// a solution can try another layout by changing only the type of its grid.
+// RowMajor stores each row, including its border, contiguously, which suits
+// scans in reading order. Blocked<N> stores N by N tiles contiguously, so that
+// cells which are close in both directions tend to share cache lines, which
+// suits searches that spread out in every direction.
+
+#pragma once
+
+#include "vec2.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+// Coordinates given to a layout include the border, so they are never
+// negative.
+class RowMajor {
+ public:
+  static constexpr bool kContiguousRows = true;
+
+  RowMajor(int width, int height)
+      : stride_(width), size_(std::size_t(width) * height) {}
+
+  std::size_t size() const { return size_; }
+  std::size_t Index(int x, int y) const {
+    return std::size_t(y) * stride_ + x;
+  }
+  // Index(x, y) - Index(x - 1, y).
+  static std::ptrdiff_t Step(int) { return 1; }
+
+ private:
+  std::size_t stride_, size_;
+};
+
+template <int kTileSize>
+class Blocked {
+ public:
+  static_assert(kTileSize > 0 && (kTileSize & (kTileSize - 1)) == 0,
+                "tiles must be a power of two in size");
+  static constexpr bool kContiguousRows = false;
+
+  Blocked(int width, int height)
+      : tiles_per_row_(Tiles(width)),
+        size_(tiles_per_row_ * Tiles(height) * kTileSize * kTileSize) {}
+
+  std::size_t size() const { return size_; }
+  std::size_t Index(int x, int y) const {
+    // Unsigned, so that the divisions are shifts.
+    const unsigned ux = x, uy = y;
+    std::size_t tile = uy / kTileSize * tiles_per_row_ + ux / kTileSize;
+    return (tile * kTileSize + uy % kTileSize) * kTileSize + ux % kTileSize;
+  }
+  // Index(x, y) - Index(x - 1, y), which jumps to the next tile at its edge.
+  static std::ptrdiff_t Step(int x) {
+    return x % kTileSize ? 1 : kTileSize * kTileSize - kTileSize + 1;
+  }
+
+ private:
+  static std::size_t Tiles(int n) { return (n + kTileSize - 1) / kTileSize; }
+
+  std::size_t tiles_per_row_, size_;
+};
+
+template <typename T, typename Layout = RowMajor>
+class Grid2D {
+ public:
+  Grid2D(int width, int height, T value = T{})
+      : Grid2D(width, height, value, 0, value) {}
+
+  // The border is border cells deep on every side, and holds sentinel.
+  Grid2D(int width, int height, T value, int border, T sentinel)
+      : width_(width),
+        height_(height),
+        border_(border),
+        layout_(width + 2 * border, height + 2 * border),
+        cells_(layout_.size(), sentinel) {
+    if (border == 0 && value == sentinel) return;
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) (*this)(x, y) = value;
+    }
+  }
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  int border() const { return border_; }
+
+  // Cells in the border can be read and written like any other.
+  T& operator()(int x, int y) { return cells_[Index(x, y)]; }
+  const T& operator()(int x, int y) const { return cells_[Index(x, y)]; }
+
+  template <typename U>
+  T& operator[](vec2<U> p) {
+    return (*this)(p.x, p.y);
+  }
+  template <typename U>
+  const T& operator[](vec2<U> p) const {
+    return (*this)(p.x, p.y);
+  }
+
+  // Above, left, right and below. The border must be at least one cell deep
+  // unless (x, y) is inside the edge.
+  std::array<T, 4> Neighbours4(int x, int y) const {
+    const Grid2D& g = *this;
+    return {g(x, y - 1), g(x - 1, y), g(x + 1, y), g(x, y + 1)};
+  }
+
+  std::array<T, 8> Neighbours8(int x, int y) const {
+    const Grid2D& g = *this;
+    return {g(x - 1, y - 1), g(x, y - 1), g(x + 1, y - 1),
+            g(x - 1, y),                  g(x + 1, y),
+            g(x - 1, y + 1), g(x, y + 1), g(x + 1, y + 1)};
+  }
+
+  // Iterators step from cell to cell rather than finding the index of each
+  // one, and only find it afresh at the start of each row. They compare by
+  // cell, and point at no cell once they are past the last row.
+  template <typename Grid, typename Reference>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::remove_reference_t<Reference>*;
+    using reference = Reference;
+
+    Iterator() = default;
+    Iterator(Grid* grid, int x, int y) : grid_(grid), x_(x), y_(y) {
+      if (y < grid->height()) cell_ = &(*grid)(x, y);
+    }
+
+    Reference operator*() const { return *cell_; }
+    pointer operator->() const { return cell_; }
+    Iterator& operator++() {
+      if (++x_ < grid_->width()) {
+        cell_ += Layout::Step(x_ + grid_->border());
+      } else {
+        x_ = 0;
+        cell_ = ++y_ < grid_->height() ? &(*grid_)(0, y_) : nullptr;
+      }
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator old = *this;
+      ++*this;
+      return old;
+    }
+    bool operator==(const Iterator& other) const {
+      return cell_ == other.cell_;
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    int x() const { return x_; }
+    int y() const { return y_; }
+
+   private:
+    Grid* grid_ = nullptr;
+    pointer cell_ = nullptr;
+    int x_ = 0, y_ = 0;
+  };
+
+  using iterator = Iterator<Grid2D, T&>;
+  using const_iterator = Iterator<const Grid2D, const T&>;
+
+  template <typename I>
+  struct Range {
+    I first, last;
+    I begin() const { return first; }
+    I end() const { return last; }
+  };
+
+  iterator begin() { return {this, 0, 0}; }
+  iterator end() { return {this, 0, height_}; }
+  const_iterator begin() const { return {this, 0, 0}; }
+  const_iterator end() const { return {this, 0, height_}; }
+
+  Range<iterator> Row(int y) { return {{this, 0, y}, {this, 0, y + 1}}; }
+  Range<const_iterator> Row(int y) const {
+    return {{this, 0, y}, {this, 0, y + 1}};
+  }
+
+  // The number of cells outside the border for which pred is true. Where rows
+  // are contiguous, each is counted as an array, which is much faster than
+  // counting through iterators.
+  template <typename Predicate>
+  int CountIf(Predicate pred) const {
+    int count = 0;
+    for (int y = 0; y < height_; y++) {
+      if constexpr (Layout::kContiguousRows) {
+        const T* row = &(*this)(0, y);
+        count += std::count_if(row, row + width_, pred);
+      } else {
+        for (const T& cell : Row(y)) count += bool(pred(cell));
+      }
+    }
+    return count;
+  }
+  int Count(const T& value) const {
+    return CountIf([&value](const T& cell) { return cell == value; });
+  }
+
+  // Grids are equal if they have the same size and cells, including those in
+  // the border.
+  bool operator==(const Grid2D& other) const {
+    return width_ == other.width_ && height_ == other.height_ &&
+           border_ == other.border_ && cells_ == other.cells_;
+  }
+  bool operator!=(const Grid2D& other) const { return !(*this == other); }
+
+  // Sets every cell, including those in the border.
+  void Fill(T value) { std::fill(cells_.begin(), cells_.end(), value); }
+
+ private:
+  std::size_t Index(int x, int y) const {
+    assert(-border_ <= x && x < width_ + border_);
+    assert(-border_ <= y && y < height_ + border_);
+    return layout_.Index(x + border_, y + border_);
+  }
+
+  int width_, height_, border_;
+  Layout layout_;
+  std::vector<T> cells_;
+};
@@ -0,0 +1,43 @@
+// Hashing for small keys such as coordinates. std::hash of an integer is the
+// identity, and a combination such as (x * 19) ^ (y * 37) maps the small,
+// clustered coordinates of a grid onto only a few distinct values. Keys are
+// instead packed into a single integer and passed through a mixer, so that
+// every bit of the key affects every bit of the hash:
+//
+// std::size_t operator()(vec2<int> v) const {
+//   return HashMix(HashPack(v.x, v.y));
+// }
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+// The finalizer of SplitMix64, which is a bijection on 64-bit values.
+constexpr std::uint64_t HashMix(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9u;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebu;
+  x ^= x >> 31;
+  return x;
+}
+
+// Packs two integers of up to 32 bits into one value without losing any bits.
+template <typename T>
+constexpr std::uint64_t HashPack(T x, T y) {
+  static_assert(std::is_integral_v<T> && sizeof(T) <= 4);
+  return std::uint64_t{static_cast<std::uint32_t>(x)} << 32 |
+         static_cast<std::uint32_t>(y);
+}
+
+// std::hash followed by HashMix(), for keys such as integers whose std::hash
+// is not mixed.
+template <typename T>
+struct MixedHash {
+  std::size_t operator()(const T& value) const {
+    return HashMix(std::hash<T>{}(value));
+  }
+};
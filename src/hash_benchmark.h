@@ -0,0 +1,164 @@
+// Benchmark of FlatHashSet against std::unordered_set, with the old and the
+// mixed hashes, on keys like those that the solutions use
+// (./solve --hash-benchmark):
+//
+// Rooms (day 20), 40401 keys:
+//   std::unordered_set, (x * 19) ^ (y * 37)  insert  ... M/s, hit ... M/s, ...
+//   std::unordered_set, mixed hash           insert  ... M/s, hit ... M/s, ...
+//   FlatHashSet, mixed hash                  insert  ... M/s, hit ... M/s, ...
+//
+// Insertion starts from an empty set each time, and lookups are made for every
+// key and then for the same number of keys which are absent. The probe length
+// of a key is the number of keys compared in its bucket for
+// std::unordered_set, or the number of groups of 16 slots examined for
+// FlatHashSet. Rates are of the median run, and --time-budget and --max-runs
+// apply to each measurement.
+
+#pragma once
+
+#include "flat_hash.h"
+#include "timing.h"
+#include "vec2.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace hash_benchmark_internal {
+
+// The hash that vec2 had before it was mixed.
+struct LegacyHash {
+  template <typename T>
+  std::size_t operator()(vec2<T> v) const {
+    return (v.x * 19) ^ (v.y * 37);
+  }
+};
+
+template <typename Key, typename Hash>
+std::size_t ProbeLength(const std::unordered_set<Key, Hash>& set,
+                        const Key& key) {
+  std::size_t length = 1;
+  for (auto i = set.begin(set.bucket(key)); !(*i == key); ++i) length++;
+  return length;
+}
+
+template <typename Key, typename Hash>
+std::size_t ProbeLength(const FlatHashSet<Key, Hash>& set, const Key& key) {
+  return set.ProbeLength(key);
+}
+
+template <typename Set, typename Key>
+void Measure(std::string_view name, const std::vector<Key>& keys,
+             const std::vector<Key>& absent, const BenchmarkOptions& options) {
+  auto insert = [&] {
+    Set set;
+    for (const Key& key : keys) set.insert(key);
+    return set.size();
+  };
+  Set set;
+  for (const Key& key : keys) set.insert(key);
+  auto lookup = [&set](const std::vector<Key>& lookups) {
+    return [&set, &lookups] {
+      std::size_t found = 0;
+      for (const Key& key : lookups) found += set.count(key);
+      return found;
+    };
+  };
+  // Millions of keys per second.
+  auto rate = [&](const Statistics& statistics) {
+    return keys.size() * 1e3 / statistics.median.count();
+  };
+  // Benchmark() keeps the result of every run, so none of the inserts or
+  // lookups can be optimised away. Checking the results makes them observable
+  // here too.
+  auto inserted = Benchmark(insert, options);
+  auto hits = Benchmark(lookup(keys), options);
+  auto misses = Benchmark(lookup(absent), options);
+  if (inserted.value != keys.size() || hits.value != keys.size() ||
+      misses.value != 0) {
+    std::cerr << name << ": inserted " << inserted.value << " keys, found "
+              << hits.value << " of them and " << misses.value
+              << " absent keys.\n";
+  }
+  double insert_rate = rate(inserted.statistics);
+  double hit_rate = rate(hits.statistics);
+  double miss_rate = rate(misses.statistics);
+  std::size_t total_probes = 0, max_probes = 0;
+  for (const Key& key : keys) {
+    std::size_t probes = ProbeLength(set, key);
+    total_probes += probes;
+    max_probes = std::max(max_probes, probes);
+  }
+  std::ios::fmtflags flags = std::cout.flags();
+  std::cout << "  " << std::left << std::setw(40) << name << std::right
+            << std::fixed << std::setprecision(1) << " insert "
+            << std::setw(6) << insert_rate << "M/s, hit " << std::setw(6)
+            << hit_rate << "M/s, miss " << std::setw(6) << miss_rate
+            << "M/s, probes " << std::setprecision(2)
+            << static_cast<double>(total_probes) / keys.size() << " mean, "
+            << max_probes << " max\n";
+  std::cout.flags(flags);
+}
+
+}  // namespace hash_benchmark_internal
+
+inline int RunHashBenchmark(const BenchmarkOptions& options) {
+  using namespace hash_benchmark_internal;
+  {
+    // Rooms are at even coordinates, and the walls between them, which are
+    // looked up but never stored, at odd ones.
+    std::vector<vec2<int>> rooms, walls;
+    for (int y = -200; y <= 200; y += 2) {
+      for (int x = -200; x <= 200; x += 2) {
+        rooms.push_back({x, y});
+        walls.push_back({x + 1, y});
+      }
+    }
+    std::cout << "Rooms (day 20), " << rooms.size() << " keys:\n";
+    Measure<std::unordered_set<vec2<int>, LegacyHash>>(
+        "std::unordered_set, (x * 19) ^ (y * 37)", rooms, walls, options);
+    Measure<std::unordered_set<vec2<int>>>("std::unordered_set, mixed hash",
+                                           rooms, walls, options);
+    Measure<FlatHashSet<vec2<int>>>("FlatHashSet, mixed hash", rooms, walls,
+                                    options);
+  }
+  {
+    // A tall, narrow region next to the mouth of the cave.
+    std::vector<vec2<short>> explored, unexplored;
+    for (short y = 0; y < 800; y++) {
+      for (short x = 0; x < 40; x++) {
+        explored.push_back({x, y});
+        unexplored.push_back({static_cast<short>(x + 40), y});
+      }
+    }
+    std::cout << "Cave (day 22), " << explored.size() << " keys:\n";
+    Measure<std::unordered_set<vec2<short>, LegacyHash>>(
+        "std::unordered_set, (x * 19) ^ (y * 37)", explored, unexplored,
+        options);
+    Measure<std::unordered_set<vec2<short>>>("std::unordered_set, mixed hash",
+                                             explored, unexplored, options);
+    Measure<FlatHashSet<vec2<short>>>("FlatHashSet, mixed hash", explored,
+                                      unexplored, options);
+  }
+  {
+    // Frequencies cluster in a range, but needn't be consecutive.
+    std::vector<int> seen, unseen;
+    for (int i = -50000; i < 50000; i++) {
+      seen.push_back(3 * i);
+      unseen.push_back(3 * i + 1);
+    }
+    std::cout << "Frequencies (day 1), " << seen.size() << " keys:\n";
+    Measure<std::unordered_set<int>>("std::unordered_set, std::hash", seen,
+                                     unseen, options);
+    Measure<std::unordered_set<int, MixedHash<int>>>(
+        "std::unordered_set, mixed hash", seen, unseen, options);
+    Measure<FlatHashSet<int, MixedHash<int>>>("FlatHashSet, mixed hash", seen,
+                                              unseen, options);
+  }
+  return 0;
+}
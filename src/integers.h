@@ -0,0 +1,195 @@
+// Bulk extraction of every integer in a string. Many puzzle inputs are little
+// more than decimal integers wrapped in punctuation, so instead of parsing the
+// syntax around them, a parser can pull all of the numbers out in one pass and
+// pick the fields out by index:
+//
+// // pos=<26057576,-10751309,46491633>, r=91461401
+// std::vector<int> numbers = ExtractAllIntegers(puzzle);
+// for (std::size_t i = 0; i + 4 <= numbers.size(); i += 4) {
+//   Nanobot bot{{numbers[i], numbers[i + 1], numbers[i + 2]}, numbers[i + 3]};
+//   ...
+// }
+//
+// An integer is a maximal run of decimal digits, and is negative if the digits
+// directly follow a '-'. The input is classified 64 bytes at a time with AVX2
+// or SSE2 where the CPU has them, and up to 8 digits are converted at once, so
+// the scalar work is done once per integer rather than once per byte.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INTEGERS_X86
+#endif
+
+namespace integers_internal {
+
+constexpr bool IsDigit(char c) { return '0' <= c && c <= '9'; }
+
+// Bit i of each mask is set if data[i] is a digit.
+inline std::uint64_t DigitMaskScalar(const char* data, std::size_t size) {
+  std::uint64_t mask = 0;
+  for (std::size_t i = 0; i < size; i++) {
+    mask |= std::uint64_t{IsDigit(data[i])} << i;
+  }
+  return mask;
+}
+
+inline std::uint64_t DigitMask64Scalar(const char* data) {
+  return DigitMaskScalar(data, 64);
+}
+
+// For each byte, c - '0' is at most 9 as an unsigned value iff c is a digit.
+#ifdef __SSE2__
+inline std::uint64_t DigitMask64Sse2(const char* data) {
+  const __m128i zero = _mm_set1_epi8('0'), nine = _mm_set1_epi8(9);
+  std::uint64_t mask = 0;
+  for (int i = 0; i < 4; i++) {
+    __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i));
+    __m128i offset = _mm_sub_epi8(bytes, zero);
+    __m128i digits = _mm_cmpeq_epi8(_mm_min_epu8(offset, nine), offset);
+    mask |= std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(digits))}
+            << (16 * i);
+  }
+  return mask;
+}
+#endif  // __SSE2__
+
+#ifdef INTEGERS_X86
+__attribute__((target("avx2")))
+inline std::uint64_t DigitMask64Avx2(const char* data) {
+  const __m256i zero = _mm256_set1_epi8('0'), nine = _mm256_set1_epi8(9);
+  __m256i low = _mm256_sub_epi8(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), zero);
+  __m256i high = _mm256_sub_epi8(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32)), zero);
+  low = _mm256_cmpeq_epi8(_mm256_min_epu8(low, nine), low);
+  high = _mm256_cmpeq_epi8(_mm256_min_epu8(high, nine), high);
+  return std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(high))}
+             << 32 |
+         static_cast<std::uint32_t>(_mm256_movemask_epi8(low));
+}
+#endif  // INTEGERS_X86
+
+// Converts up to 8 digits at once. The digits are at the start of the 8 bytes
+// in data, and anything after them is ignored.
+inline std::uint64_t ParseDigits(const char* data, std::size_t length) {
+  std::uint64_t chunk;
+  std::memcpy(&chunk, data, 8);
+  // Shifting the digits to the top leaves leading zeroes in their place, and
+  // drops the bytes after them along with any borrows from the subtraction.
+  chunk = (chunk - 0x3030303030303030) << (8 * (8 - length));
+  chunk = chunk * 10 + (chunk >> 8);
+  chunk = ((chunk & 0x000000FF000000FF) * (100 + (1000000ULL << 32)) +
+           ((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32))) >>
+          32;
+  return chunk;
+}
+
+template <typename T, std::uint64_t (*DigitMask64)(const char*)>
+inline std::size_t Extract(std::string_view input, T* output,
+                           std::size_t capacity, std::size_t* consumed) {
+  const char* data = input.data();
+  std::size_t size = input.size();
+  std::size_t count = 0;
+  // 1 if the byte before the current block is a digit.
+  std::uint64_t carry = 0;
+  for (std::size_t block = 0; block < size; block += 64) {
+    std::size_t length = std::min<std::size_t>(64, size - block);
+    std::uint64_t digits = length == 64
+                               ? DigitMask64(data + block)
+                               : DigitMaskScalar(data + block, length);
+    // The first digit of each integer, ignoring those which carry on from the
+    // previous block since they have already been read.
+    std::uint64_t starts = digits & ~(digits << 1 | carry);
+    carry = digits >> 63;
+    for (; starts; starts &= starts - 1) {
+      std::size_t bit = __builtin_ctzll(starts);
+      std::size_t i = block + bit;
+      std::size_t end = i + __builtin_ctzll(~(digits >> bit));
+      // The mask only covers this block, so a run reaching its end may go on.
+      if (end == block + 64) {
+        while (end < size && IsDigit(data[end])) end++;
+      }
+      std::uint64_t value = 0;
+      for (; end - i > 8; i++) value = 10 * value + (data[i] - '0');
+      if (i + 8 <= size) {
+        value = value * 100000000 + ParseDigits(data + i, end - i);
+      } else {
+        char tail[8] = {};
+        std::memcpy(tail, data + i, size - i);
+        value = value * 100000000 + ParseDigits(tail, end - i);
+      }
+      bool negative = block + bit > 0 && data[block + bit - 1] == '-';
+      output[count++] = negative ? static_cast<T>(-static_cast<T>(value))
+                                 : static_cast<T>(value);
+      if (count == capacity) {
+        if (consumed) *consumed = end;
+        return count;
+      }
+    }
+  }
+  if (consumed) *consumed = size;
+  return count;
+}
+
+#ifdef INTEGERS_X86
+// The whole loop is compiled for AVX2 so that the mask can be inlined into it.
+template <typename T>
+__attribute__((target("avx2"))) std::size_t ExtractAvx2(
+    std::string_view input, T* output, std::size_t capacity,
+    std::size_t* consumed) {
+  return Extract<T, DigitMask64Avx2>(input, output, capacity, consumed);
+}
+#endif  // INTEGERS_X86
+
+}  // namespace integers_internal
+
+// Writes up to capacity integers from the input to output, and returns how many
+// were written. If consumed is given, it is set to the length of the input
+// which was read, so that extraction can carry on from there.
+template <typename T = int>
+std::size_t ExtractIntegers(std::string_view input, T* output,
+                            std::size_t capacity,
+                            std::size_t* consumed = nullptr) {
+  using namespace integers_internal;
+  static_assert(std::is_integral_v<T>);
+  assert(capacity > 0);
+#ifdef INTEGERS_X86
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (has_avx2) return ExtractAvx2(input, output, capacity, consumed);
+#endif  // INTEGERS_X86
+#ifdef __SSE2__
+  return Extract<T, DigitMask64Sse2>(input, output, capacity, consumed);
+#else
+  return Extract<T, DigitMask64Scalar>(input, output, capacity, consumed);
+#endif  // __SSE2__
+}
+
+// Extracts every integer in the input. The output grows a chunk at a time
+// rather than being sized up front for the worst case.
+template <typename T = int>
+std::vector<T> ExtractAllIntegers(std::string_view input) {
+  constexpr std::size_t kChunkSize = 4096;
+  std::vector<T> output;
+  while (true) {
+    std::size_t size = output.size();
+    output.resize(size + kChunkSize);
+    std::size_t consumed;
+    std::size_t count =
+        ExtractIntegers(input, output.data() + size, kChunkSize, &consumed);
+    output.resize(size + count);
+    if (count < kChunkSize) return output;
+    input.remove_prefix(consumed);
+  }
+}
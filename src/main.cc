@@ -0,0 +1,29 @@
+#include "allocation.h"
+#include "driver.h"
+#include "registry.h"
+
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+  bool show_allocation_stats, show_size_histogram, show_heap_profile;
+  int status;
+  {
+    // The options are destroyed before the allocation stats are displayed so
+    // that they don't show up as a leak.
+    const Options options = ParseOptions(argc, argv);
+    // Generated inputs are written to stdout, so nothing else can be.
+    show_allocation_stats =
+        options.format == Format::kText && !options.generate;
+    show_size_histogram = show_allocation_stats && options.allocations;
+    show_heap_profile = options.heap_profile > 0;
+    status = RunSolutions(options, Registry());
+  }
+  if (show_size_histogram)
+    std::cout << "Allocations by size:\n" << GetSizeHistogram();
+  if (show_allocation_stats) dump_allocation_stats();
+  // Reports in other formats are left intact by writing the profile to stderr
+  // instead.
+  if (show_heap_profile)
+    PrintHeapProfile(show_allocation_stats ? std::cout : std::cerr);
+  return status;
+}
@@ -0,0 +1,75 @@
+// Read-only memory mapping of a file. The contents are exposed as a
+// std::string_view so that they can be used in place of an embedded puzzle
+// input without copying:
+//
+// auto file = MappedFile::Open("big_input.txt");
+// if (!file) ...
+// std::string_view contents = file->contents();
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+class MappedFile {
+ public:
+  // Returns nullopt if the file could not be opened or mapped.
+  static std::optional<MappedFile> Open(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) return std::nullopt;
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+      close(fd);
+      return std::nullopt;
+    }
+    std::size_t size = info.st_size;
+    // Mapping an empty file is an error, but an empty view is fine.
+    void* data = nullptr;
+    if (size > 0) {
+      data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        return std::nullopt;
+      }
+      // Inputs are parsed from start to finish.
+      madvise(data, size, MADV_SEQUENTIAL);
+    }
+    // The mapping remains valid after the descriptor is closed.
+    close(fd);
+    return MappedFile{static_cast<const char*>(data), size};
+  }
+
+  MappedFile(MappedFile&& other)
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  MappedFile& operator=(MappedFile&& other) {
+    if (this != &other) {
+      Unmap();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  ~MappedFile() { Unmap(); }
+
+  std::string_view contents() const { return {data_, size_}; }
+
+ private:
+  MappedFile(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+  void Unmap() {
+    if (data_) munmap(const_cast<char*>(data_), size_);
+  }
+
+  const char* data_;
+  std::size_t size_;
+};
@@ -0,0 +1,148 @@
+// Hardware performance counters via Linux perf_event_open(). PerfCounters opens
+// one counter per event for the calling thread, counting user space only so
+// that it works with the default perf_event_paranoid setting. Events that the
+// kernel or hardware does not allow are skipped, so any subset of the counts
+// may be missing:
+//
+// PerfCounters counters;
+// counters.Start();
+// Work();
+// PerfCounts counts = counters.Stop();
+//
+// Counts are printed as something like:
+//
+// 102M cycles, 250M instructions, 1203K cache misses, 38K branch misses, ...
+
+#pragma once
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <optional>
+
+struct PerfEvent {
+  const char* name;
+  // Name used as a key in machine-readable reports.
+  const char* key;
+  std::uint32_t type;
+  std::uint64_t config;
+};
+
+inline constexpr PerfEvent kPerfEvents[] = {
+    {"cycles", "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", "instructions", PERF_TYPE_HARDWARE,
+     PERF_COUNT_HW_INSTRUCTIONS},
+    {"cache misses", "cache_misses", PERF_TYPE_HARDWARE,
+     PERF_COUNT_HW_CACHE_MISSES},
+    {"branch misses", "branch_misses", PERF_TYPE_HARDWARE,
+     PERF_COUNT_HW_BRANCH_MISSES},
+    {"page faults", "page_faults", PERF_TYPE_SOFTWARE,
+     PERF_COUNT_SW_PAGE_FAULTS},
+};
+constexpr std::size_t kNumPerfEvents = std::size(kPerfEvents);
+
+// One count per entry in kPerfEvents, or nullopt if that event is unavailable.
+using PerfCounts = std::array<std::optional<std::uint64_t>, kNumPerfEvents>;
+
+// Wrapper for printing a large count with an appropriate suffix.
+struct Count {
+  std::uint64_t value;
+};
+
+inline std::ostream& operator<<(std::ostream& output, Count count) {
+  if (count.value < 10'000) {
+    return output << count.value;
+  } else if (count.value < 10'000'000) {
+    return output << count.value / 1'000 << "K";
+  } else if (count.value < 10'000'000'000) {
+    return output << count.value / 1'000'000 << "M";
+  } else {
+    return output << count.value / 1'000'000'000 << "G";
+  }
+}
+
+inline std::ostream& operator<<(std::ostream& output,
+                                const PerfCounts& counts) {
+  bool first = true;
+  for (std::size_t i = 0; i < kNumPerfEvents; i++) {
+    if (!counts[i]) continue;
+    if (!first) output << ", ";
+    output << Count{*counts[i]} << " " << kPerfEvents[i].name;
+    first = false;
+  }
+  return output;
+}
+
+class PerfCounters {
+ public:
+  PerfCounters() {
+    for (std::size_t i = 0; i < kNumPerfEvents; i++) {
+      perf_event_attr attributes;
+      std::memset(&attributes, 0, sizeof(attributes));
+      attributes.size = sizeof(attributes);
+      attributes.type = kPerfEvents[i].type;
+      attributes.config = kPerfEvents[i].config;
+      attributes.disabled = 1;
+      attributes.exclude_kernel = 1;
+      attributes.exclude_hv = 1;
+      // If there are more events than hardware counters, the kernel will
+      // multiplex them. These let us scale the counts to compensate.
+      attributes.read_format =
+          PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      fds_[i] = syscall(SYS_perf_event_open, &attributes, /*pid=*/0,
+                        /*cpu=*/-1, /*group_fd=*/-1, /*flags=*/0);
+    }
+  }
+
+  ~PerfCounters() {
+    for (int fd : fds_) {
+      if (fd != -1) close(fd);
+    }
+  }
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  // True if at least one of the events can be counted.
+  bool available() const {
+    for (int fd : fds_) {
+      if (fd != -1) return true;
+    }
+    return false;
+  }
+
+  void Start() {
+    for (int fd : fds_) {
+      if (fd == -1) continue;
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  PerfCounts Stop() {
+    for (int fd : fds_) {
+      if (fd != -1) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    PerfCounts counts;
+    for (std::size_t i = 0; i < kNumPerfEvents; i++) {
+      if (fds_[i] == -1) continue;
+      struct { std::uint64_t value, time_enabled, time_running; } data;
+      if (read(fds_[i], &data, sizeof(data)) != ssize_t{sizeof(data)}) continue;
+      if (data.time_running == 0) continue;  // Never scheduled.
+      counts[i] = static_cast<std::uint64_t>(
+          static_cast<double>(data.value) * data.time_enabled /
+          data.time_running);
+    }
+    return counts;
+  }
+
+ private:
+  std::array<int, kNumPerfEvents> fds_;
+};
@@ -0,0 +1,195 @@
+// Registry of solutions. Each dayN.cc registers its solutions after defining
+// them:
+//
+// int Solve1A(std::string_view puzzle) { ... }
+// REGISTER_SOLUTION(Solve1A);
+//
+// Solutions are given their puzzle input rather than reading kPuzzleN
+// themselves, so the same solution can be run on any number of inputs.
+//
+// Registration happens during static initialization and does not allocate.
+// Registry() returns every registered solution ordered by day and then part.
+//
+// Alternative implementations of a part can be kept alongside the main one by
+// naming them SolveNX_Variant and registering them in the same way:
+//
+// int Solve5B_ReactFirst(std::string_view puzzle) { ... }
+// REGISTER_SOLUTION(Solve5B_ReactFirst);
+//
+// Variants only run with --variants, which checks them against the main
+// solution and benchmarks them side by side.
+//
+// Solutions which can read their input a line at a time, without holding all
+// of it in memory, take a LineReader from stream.h instead and are registered
+// with REGISTER_STREAMING_SOLUTION. They are named as variants, such as
+// Solve1B_Stream, and run with the whole input like any other variant, but
+// --stdin can also run them on an input piped to standard input.
+//
+// The fast runtime has its own simpler registry, in fast/registry.h.
+
+#pragma once
+
+#ifdef FAST_RUNTIME
+#include "fast/registry.h"
+#else  // FAST_RUNTIME
+
+#include "allocation.h"
+#include "perf.h"
+#include "stream.h"
+#include "timing.h"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+struct Solution {
+  // The function name, such as "Solve12B".
+  std::string_view name;
+  int day;
+  char part;
+  // Empty for the main solution of a part, or the name of an alternative
+  // implementation, such as "ReactFirst" for Solve5B_ReactFirst.
+  std::string_view variant;
+  TimingResult<std::string> (*run)(std::string_view puzzle, AllocationStats*,
+                                   PerfCounters*);
+  BenchmarkResult<std::string> (*benchmark)(std::string_view puzzle,
+                                            const BenchmarkOptions&);
+  // Runs a streaming solution on the given file descriptor, or is null for
+  // other solutions. Returns nullopt if reading failed.
+  std::optional<TimingResult<std::string>> (*stream)(int fd,
+                                                     AllocationStats*) =
+      nullptr;
+};
+
+// Answers are all either integers or strings. Converting them to strings lets
+// every solution share a single signature.
+inline std::string ToString(std::string value) { return value; }
+
+template <typename T>
+std::string ToString(T value) {
+  static_assert(std::is_integral_v<T>);
+  return std::to_string(value);
+}
+
+// Time a single solution and track its allocations, and also collect
+// performance counters if counters is not null. The conversion to a string
+// happens outside of the timed region and is not tracked, so only memory which
+// the solution itself failed to release is reported as leaked.
+template <typename F>
+TimingResult<std::string> RunTracked(F call, AllocationStats* allocations,
+                                     PerfCounters* counters) {
+  TimingResult<std::string> result;
+  AllocationScope scope;
+  {
+    auto timing = counters ? Time(call, counters) : Time(call);
+    // The answer is copied rather than moved so that the original is freed
+    // while it is still being tracked.
+    UntrackedAllocations untracked;
+    result = TimingResult<std::string>{ToString(timing.value), timing.time,
+                                       timing.counters};
+  }
+  *allocations = scope.stats();
+  return result;
+}
+
+template <auto* solve>
+TimingResult<std::string> Run(std::string_view puzzle,
+                              AllocationStats* allocations,
+                              PerfCounters* counters) {
+  return RunTracked([puzzle] { return solve(puzzle); }, allocations, counters);
+}
+
+// The reader is created inside the tracked region, so its buffer counts
+// towards the peak usage.
+template <auto* solve>
+std::optional<TimingResult<std::string>> RunStream(
+    int fd, AllocationStats* allocations) {
+  bool failed = false;
+  auto call = [fd, &failed] {
+    LineReader lines{fd};
+    auto answer = solve(lines);
+    failed = lines.failed();
+    return answer;
+  };
+  auto result = RunTracked(call, allocations, nullptr);
+  if (failed) return std::nullopt;
+  return result;
+}
+
+template <auto* solve>
+BenchmarkResult<std::string> RunBenchmark(std::string_view puzzle,
+                                          const BenchmarkOptions& options) {
+  auto [value, statistics] =
+      Benchmark([puzzle] { return solve(puzzle); }, options);
+  return BenchmarkResult<std::string>{ToString(std::move(value)), statistics};
+}
+
+// Solution names have the form SolveNX, where N is the day and X is the part,
+// optionally followed by _Variant.
+constexpr Solution MakeSolution(
+    std::string_view name,
+    TimingResult<std::string> (*run)(std::string_view, AllocationStats*,
+                                     PerfCounters*),
+    BenchmarkResult<std::string> (*benchmark)(std::string_view,
+                                              const BenchmarkOptions&),
+    std::optional<TimingResult<std::string>> (*stream)(int, AllocationStats*) =
+        nullptr) {
+  int day = 0;
+  std::size_t i = name.find_first_of("0123456789");
+  for (; i < name.size() && '0' <= name[i] && name[i] <= '9'; i++)
+    day = 10 * day + (name[i] - '0');
+  char part = i < name.size() ? name[i] : '?';
+  std::string_view variant;
+  if (i + 1 < name.size() && name[i + 1] == '_') variant = name.substr(i + 2);
+  return Solution{name, day, part, variant, run, benchmark, stream};
+}
+
+// Each registration is a node in an intrusive list of every solution.
+class Registration {
+ public:
+  explicit Registration(Solution solution)
+      : solution_(solution), next_(head_) {
+    head_ = this;
+  }
+
+  Registration(const Registration&) = delete;
+  Registration& operator=(const Registration&) = delete;
+
+  static std::vector<Solution> All() {
+    std::vector<Solution> solutions;
+    for (const Registration* i = head_; i; i = i->next_)
+      solutions.push_back(i->solution_);
+    std::sort(solutions.begin(), solutions.end(),
+              [](const Solution& a, const Solution& b) {
+                return std::tie(a.day, a.part, a.variant) <
+                       std::tie(b.day, b.part, b.variant);
+              });
+    return solutions;
+  }
+
+ private:
+  // This is constant-initialized, so it is safe to use from the constructors
+  // of other static objects.
+  static inline const Registration* head_ = nullptr;
+
+  const Solution solution_;
+  const Registration* const next_;
+};
+
+#define REGISTER_SOLUTION(function)                         \
+  static const Registration function##_registration{        \
+      MakeSolution(#function, Run<function>, RunBenchmark<function>)}
+
+#define REGISTER_STREAMING_SOLUTION(function)               \
+  static const Registration function##_registration{        \
+      MakeSolution(#function, Run<SolveInChunks<function>>, \
+                   RunBenchmark<SolveInChunks<function>>,   \
+                   RunStream<function>)}
+
+inline std::vector<Solution> Registry() { return Registration::All(); }
+
+#endif  // FAST_RUNTIME
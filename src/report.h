@@ -0,0 +1,345 @@
+// Machine-readable reports. Each solution produces a Record, which can be
+// written as text (the default, matching golden.txt), JSON or CSV. The JSON
+// format has one record per line:
+//
+// [
+// {"name": "Solve1A", "answer": "435", "time_ns": 683000, ...},
+// ...
+// ]
+//
+// ReadReport() reads back a JSON report and Compare() checks a new set of
+// records against it, flagging changed answers and time regressions.
+// CompareVariants() does the same for variants of a solution within a single
+// set of records.
+
+#pragma once
+
+#include "allocation.h"
+#include "perf.h"
+#include "timing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class Format { kText, kJson, kCsv };
+
+struct Record {
+  std::string_view name;
+  std::string answer;
+  // In benchmark mode this is the median time.
+  std::chrono::nanoseconds time;
+  std::optional<Statistics> statistics;
+  // In benchmark mode, the time of the single run made before benchmarking.
+  std::chrono::nanoseconds single_time{0};
+  // With --cold, the statistics of runs which each started with cold caches.
+  std::optional<Statistics> cold_statistics;
+  AllocationStats allocations;
+  std::optional<PerfCounts> counters;
+  // The answer came from the --cache directory rather than a run, so the time
+  // is only that of the lookup.
+  bool cached = false;
+};
+
+inline void WriteJsonString(std::ostream& output, std::string_view value) {
+  output << '"';
+  for (char c : value) {
+    switch (c) {
+      case '"': output << "\\\""; break;
+      case '\\': output << "\\\\"; break;
+      case '\n': output << "\\n"; break;
+      case '\t': output << "\\t"; break;
+      default: output << c;
+    }
+  }
+  output << '"';
+}
+
+inline void WriteCsvString(std::ostream& output, std::string_view value) {
+  output << '"';
+  for (char c : value) {
+    if (c == '"') output << '"';
+    output << c;
+  }
+  output << '"';
+}
+
+inline void WriteText(std::ostream& output, const Record& record,
+                      bool show_allocations) {
+  output << record.name << ": ";
+  if (record.statistics) {
+    output << BenchmarkResult<std::string_view>{record.answer,
+                                                *record.statistics};
+    if (record.counters) output << " (" << *record.counters << ")";
+    if (const auto& s = record.cold_statistics) {
+      output << "; cold " << Duration{s->min} << " min, "
+             << Duration{s->median} << " median, " << Duration{s->p90}
+             << " p90 (" << s->runs << " runs)";
+    }
+  } else {
+    output << TimingResult<std::string_view>{record.answer, record.time,
+                                             record.counters};
+  }
+  if (record.cached) output << " (cached)";
+  if (show_allocations) output << " [" << record.allocations << "]";
+  output << "\n";
+}
+
+inline void WriteJson(std::ostream& output, const Record& record) {
+  output << "{\"name\": ";
+  WriteJsonString(output, record.name);
+  output << ", \"answer\": ";
+  WriteJsonString(output, record.answer);
+  output << ", \"time_ns\": " << record.time.count();
+  if (record.cached) output << ", \"cached\": true";
+  if (const auto& s = record.statistics) {
+    output << ", \"min_ns\": " << s->min.count()
+           << ", \"p90_ns\": " << s->p90.count()
+           << ", \"p99_ns\": " << s->p99.count()
+           << ", \"stddev_ns\": " << s->stddev.count()
+           << ", \"runs\": " << s->runs;
+  }
+  if (const auto& s = record.cold_statistics) {
+    output << ", \"cold_min_ns\": " << s->min.count()
+           << ", \"cold_median_ns\": " << s->median.count()
+           << ", \"cold_p90_ns\": " << s->p90.count()
+           << ", \"cold_runs\": " << s->runs;
+  }
+  const AllocationStats& allocations = record.allocations;
+  output << ", \"allocations\": " << allocations.allocations
+         << ", \"bytes_allocated\": " << allocations.bytes_allocated
+         << ", \"peak_bytes\": " << allocations.peak_usage
+         << ", \"leaked_bytes\": " << allocations.leaked;
+  if (record.counters) {
+    for (std::size_t i = 0; i < kNumPerfEvents; i++) {
+      if (const auto& count = (*record.counters)[i]) {
+        output << ", \"" << kPerfEvents[i].key << "\": " << *count;
+      }
+    }
+  }
+  output << "}";
+}
+
+inline void WriteCsv(std::ostream& output, const Record& record) {
+  output << record.name << ",";
+  WriteCsvString(output, record.answer);
+  const AllocationStats& allocations = record.allocations;
+  output << "," << record.time.count() << "," << allocations.allocations << ","
+         << allocations.bytes_allocated << "," << allocations.peak_usage << ","
+         << allocations.leaked << "," << record.cached << ",";
+  // The cold time is left empty if it wasn't measured.
+  if (record.cold_statistics) output << record.cold_statistics->median.count();
+  output << "\n";
+}
+
+// Writes a sequence of records in a given format. Records are written as soon
+// as they are available, so that progress is visible for long runs.
+class ReportWriter {
+ public:
+  // show_allocations only affects the text format. The other formats always
+  // include allocation information.
+  ReportWriter(std::ostream& output, Format format, bool show_allocations)
+      : output_(output), format_(format), show_allocations_(show_allocations) {
+    if (format_ == Format::kJson) output_ << "[\n";
+    if (format_ == Format::kCsv) {
+      output_ << "name,answer,time_ns,allocations,bytes_allocated,peak_bytes,"
+                 "leaked_bytes,cached,cold_time_ns\n";
+    }
+  }
+
+  ~ReportWriter() {
+    if (format_ == Format::kJson) output_ << (empty_ ? "]\n" : "\n]\n");
+  }
+
+  void Write(const Record& record) {
+    switch (format_) {
+      case Format::kText:
+        WriteText(output_, record, show_allocations_);
+        break;
+      case Format::kJson:
+        if (!empty_) output_ << ",\n";
+        WriteJson(output_, record);
+        break;
+      case Format::kCsv:
+        WriteCsv(output_, record);
+        break;
+    }
+    empty_ = false;
+  }
+
+ private:
+  std::ostream& output_;
+  const Format format_;
+  const bool show_allocations_;
+  bool empty_ = true;
+};
+
+// A record from a previous report.
+struct PreviousRecord {
+  std::string answer;
+  std::chrono::nanoseconds time;
+};
+
+// Parse a JSON string starting at the opening quote. On success, returns the
+// string and advances the offset past the closing quote.
+inline std::optional<std::string> ParseJsonString(std::string_view line,
+                                                  std::size_t* offset) {
+  std::size_t i = *offset;
+  if (i >= line.size() || line[i] != '"') return std::nullopt;
+  std::string result;
+  for (i++; i < line.size(); i++) {
+    char c = line[i];
+    if (c == '"') {
+      *offset = i + 1;
+      return result;
+    }
+    if (c == '\\') {
+      if (++i == line.size()) return std::nullopt;
+      switch (line[i]) {
+        case 'n': c = '\n'; break;
+        case 't': c = '\t'; break;
+        default: c = line[i];
+      }
+    }
+    result.push_back(c);
+  }
+  return std::nullopt;
+}
+
+// Find the value of a field in a single-line JSON object as written by
+// WriteJson(). Returns the offset of the first character of the value.
+inline std::optional<std::size_t> FindJsonField(std::string_view line,
+                                                std::string_view field) {
+  std::string key = "\"" + std::string(field) + "\": ";
+  auto i = line.find(key);
+  if (i == std::string_view::npos) return std::nullopt;
+  return i + key.size();
+}
+
+// Read a report that was written with --format=json. Returns nullopt if the
+// file can't be read.
+inline std::optional<std::unordered_map<std::string, PreviousRecord>>
+ReadReport(std::string_view filename) {
+  std::ifstream file{std::string(filename)};
+  if (!file) return std::nullopt;
+  std::unordered_map<std::string, PreviousRecord> records;
+  for (std::string line; std::getline(file, line);) {
+    auto name_offset = FindJsonField(line, "name");
+    auto answer_offset = FindJsonField(line, "answer");
+    auto time_offset = FindJsonField(line, "time_ns");
+    if (!name_offset || !answer_offset || !time_offset) continue;
+    auto name = ParseJsonString(line, &*name_offset);
+    auto answer = ParseJsonString(line, &*answer_offset);
+    if (!name || !answer) return std::nullopt;
+    auto time = std::chrono::nanoseconds{
+        std::strtoll(line.c_str() + *time_offset, nullptr, 10)};
+    records[*name] = PreviousRecord{std::move(*answer), time};
+  }
+  return records;
+}
+
+// Slowdowns smaller than this are dominated by noise, so they are never
+// considered to be regressions regardless of the relative change.
+constexpr std::chrono::microseconds kMinRegression{100};
+
+// Compare records against a previous report, printing any differences. Returns
+// true if there were no changed answers and no regressions beyond the given
+// threshold, as a percentage.
+inline bool Compare(
+    const std::unordered_map<std::string, PreviousRecord>& previous,
+    const std::vector<Record>& records, double threshold_percent) {
+  bool ok = true;
+  for (const Record& record : records) {
+    auto i = previous.find(std::string(record.name));
+    if (i == previous.end()) {
+      std::cerr << record.name << ": not in previous report.\n";
+      continue;
+    }
+    const PreviousRecord& old = i->second;
+    if (old.answer != record.answer) {
+      std::cerr << "\x1b[31m" << record.name << ": answer changed.\x1b[0m\n";
+      ok = false;
+    }
+    auto limit = old.time.count() * (1 + threshold_percent / 100);
+    if (record.time.count() > limit &&
+        record.time - old.time > kMinRegression) {
+      std::cerr << "\x1b[31m" << record.name << ": regressed from "
+                << Duration{old.time} << " to " << Duration{record.time};
+      // There is no percentage for a change from nothing.
+      if (old.time.count() > 0) {
+        double change = 100.0 * (record.time - old.time) / old.time;
+        std::cerr << " (+" << static_cast<int>(change) << "%)";
+      }
+      std::cerr << ".\x1b[0m\n";
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+// A benchmark whose median is far below the time of a single run most likely
+// timed a call which the optimiser removed. The single run starts with cold
+// caches, but even so it is rarely more than ten times slower than the median,
+// and runs with the caches flushed are slower than it.
+inline bool ImplausibleBenchmark(const std::optional<Statistics>& statistics,
+                                 std::chrono::nanoseconds single_time) {
+  constexpr int kMaxSlowdown = 100;
+  return statistics && statistics->median * kMaxSlowdown < single_time;
+}
+
+// Compare each variant, such as Solve5B_ReactFirst, against the main solution
+// for the same part, printing the speedup. Returns true if every variant gave
+// the same answer as its main solution and both were really benchmarked.
+inline bool CompareVariants(const std::vector<Record>& records) {
+  std::unordered_map<std::string_view, const Record*> main_solutions;
+  for (const Record& record : records) {
+    if (record.name.find('_') == std::string_view::npos)
+      main_solutions.emplace(record.name, &record);
+  }
+  bool ok = true;
+  for (const Record& record : records) {
+    auto underscore = record.name.find('_');
+    if (underscore == std::string_view::npos) continue;
+    auto i = main_solutions.find(record.name.substr(0, underscore));
+    if (i == main_solutions.end()) {
+      std::cerr << record.name << ": the main solution was not run.\n";
+      continue;
+    }
+    const Record& main = *i->second;
+    if (main.answer != record.answer) {
+      std::cerr << "\x1b[31m" << record.name << ": answer " << record.answer
+                << " differs from " << main.name << ".\x1b[0m\n";
+      ok = false;
+      continue;
+    }
+    bool implausible = false;
+    for (const Record* side : {&main, &record}) {
+      if (!ImplausibleBenchmark(side->statistics, side->single_time)) continue;
+      std::cerr << "\x1b[31m" << side->name << ": the benchmark median of "
+                << Duration{side->statistics->median}
+                << " is implausibly far below a single run of "
+                << Duration{side->single_time} << ", so " << record.name
+                << " can't be compared with " << main.name << ".\x1b[0m\n";
+      implausible = true;
+    }
+    if (implausible) {
+      ok = false;
+      continue;
+    }
+    double speedup = static_cast<double>(main.time.count()) /
+                     std::max<std::chrono::nanoseconds::rep>(
+                         record.time.count(), 1);
+    auto precision = std::cerr.precision(3);
+    std::cerr << record.name << ": " << speedup << "x the speed of "
+              << main.name << " (" << Duration{record.time} << " vs "
+              << Duration{main.time} << ").\n";
+    std::cerr.precision(precision);
+  }
+  return ok;
+}
@@ -0,0 +1,113 @@
+// Allocation-free parsing of puzzle inputs. A Scanner reads directly from a
+// string_view, so the input is never copied. Like stream extraction, every
+// read first skips any whitespace, including newlines:
+//
+// // #1 @ 1,3: 4x4
+// Scanner scanner{puzzle};
+// while (!scanner.done()) {
+//   scanner.Expect("#");
+//   int id = scanner.Int();
+//   scanner.Expect("@");
+//   ...
+// }
+//
+// Consume() reports whether the input matched, and leaves it untouched if not.
+// The other reads assume that the input is well-formed and only check it with
+// asserts.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+class Scanner {
+ public:
+  constexpr explicit Scanner(std::string_view input) : input_(input) {}
+
+  // True if nothing but whitespace remains.
+  constexpr bool done() {
+    SkipWhitespace();
+    return input_.empty();
+  }
+
+  // The part of the input which has not been read yet.
+  constexpr std::string_view remaining() const { return input_; }
+
+  constexpr void SkipWhitespace() {
+    std::size_t i = 0;
+    while (i < input_.size() && IsWhitespace(input_[i])) i++;
+    input_.remove_prefix(i);
+  }
+
+  // Reads the literal if it comes next.
+  constexpr bool Consume(std::string_view literal) {
+    SkipWhitespace();
+    if (input_.substr(0, literal.size()) != literal) return false;
+    input_.remove_prefix(literal.size());
+    return true;
+  }
+
+  constexpr void Expect(std::string_view literal) {
+    [[maybe_unused]] bool found = Consume(literal);
+    assert(found);
+  }
+
+  constexpr char Char() {
+    SkipWhitespace();
+    assert(!input_.empty());
+    char c = input_.front();
+    input_.remove_prefix(1);
+    return c;
+  }
+
+  // Reads a decimal integer. Signed types accept a leading '-' or '+', while
+  // for unsigned types a '-' is left alone, so that "1518-11-01" reads as
+  // three numbers.
+  template <typename T = int>
+  constexpr T Int() {
+    static_assert(std::is_integral_v<T>);
+    SkipWhitespace();
+    std::size_t i = 0;
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+      if (!input_.empty() && (input_[0] == '-' || input_[0] == '+')) {
+        negative = input_[0] == '-';
+        i++;
+      }
+    }
+    assert(i < input_.size() && IsDigit(input_[i]));
+    T value = 0;
+    for (; i < input_.size() && IsDigit(input_[i]); i++) {
+      value = 10 * value + (input_[i] - '0');
+    }
+    input_.remove_prefix(i);
+    return negative ? static_cast<T>(-value) : value;
+  }
+
+  // Reads a run of non-whitespace characters.
+  constexpr std::string_view Word() {
+    SkipWhitespace();
+    std::size_t i = 0;
+    while (i < input_.size() && !IsWhitespace(input_[i])) i++;
+    std::string_view word = input_.substr(0, i);
+    input_.remove_prefix(i);
+    return word;
+  }
+
+  // Reads up to the end of the line and skips the newline itself.
+  constexpr std::string_view Line() {
+    SkipWhitespace();
+    std::size_t i = input_.find('\n');
+    std::string_view line = input_.substr(0, i);
+    input_.remove_prefix(i == std::string_view::npos ? input_.size() : i + 1);
+    return line;
+  }
+
+ private:
+  static constexpr bool IsWhitespace(char c) { return c == ' ' || c == '\n'; }
+  static constexpr bool IsDigit(char c) { return '0' <= c && c <= '9'; }
+
+  std::string_view input_;
+};
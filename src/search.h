@@ -0,0 +1,317 @@
+// Best-first search over an implicit graph, for the solutions which find
+// shortest paths. The graph is given by a function which lists the neighbours
+// of a state and the cost of stepping to each one:
+//
+// auto expand = [&](Position p, auto push) {
+//   for (Position next : Adjacent(p)) {
+//     if (grid[next] == '.') push(next, 1);
+//   }
+// };
+// auto settle = [&](Position p, int distance) {
+//   distances[p] = distance;
+//   return false;  // Keep going.
+// };
+// FifoFrontier<Position> frontier;
+// DenseVisited visited{width * height, [&](Position p) { ... }};
+// Search(start, frontier, visited, expand, settle);
+//
+// States are settled in order of cost, each the first time that it is taken
+// from the frontier, and settle() can stop the search by returning true. Given
+// a heuristic which never overestimates the remaining cost and which is
+// consistent, the search is A* rather than Dijkstra's algorithm.
+//
+// The frontier and the set of visited states are chosen at compile time:
+//
+// FifoFrontier      A ring buffer. Only for searches where every step costs the
+//                   same, such as breadth-first search.
+// BucketFrontier<N> A ring of N buckets, one per cost, as in Dial's algorithm.
+//                   Each step must raise the priority by less than N.
+// RadixHeap         Buckets by the highest bit in which a priority differs
+//                   from the last one taken, for any costs.
+// HeapFrontier      A binary heap, for any costs.
+//
+// DenseVisited      A bitmap, for states which can be numbered densely.
+// HashedVisited     A FlatHashSet, for any hashable states.
+//
+// Priorities are non-negative ints. Every frontier except HeapFrontier relies
+// on the search being monotone, so that nothing is pushed with a lower
+// priority than the last one taken. States of equal priority may come out in
+// any order. Frontiers and visited sets allocate from a
+// std::pmr::memory_resource. Frontiers and DenseVisited can be cleared to reuse
+// their memory for another search.
+
+#pragma once
+
+#include "flat_hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+template <typename State>
+struct FrontierEntry {
+  int priority;
+  State state;
+};
+
+template <typename State>
+class FifoFrontier {
+ public:
+  explicit FifoFrontier(std::pmr::memory_resource* resource =
+                            std::pmr::get_default_resource())
+      : entries_(resource) {}
+
+  bool empty() const { return size_ == 0; }
+  void clear() { head_ = size_ = 0; }
+
+  void push(int priority, const State& state) {
+    assert(empty() || Back().priority <= priority);
+    if (size_ == entries_.size()) Grow();
+    entries_[(head_ + size_) & Mask()] = {priority, state};
+    size_++;
+  }
+
+  FrontierEntry<State> pop() {
+    assert(!empty());
+    FrontierEntry<State> entry = entries_[head_];
+    head_ = (head_ + 1) & Mask();
+    size_--;
+    return entry;
+  }
+
+ private:
+  std::size_t Mask() const { return entries_.size() - 1; }
+  const FrontierEntry<State>& Back() const {
+    return entries_[(head_ + size_ - 1) & Mask()];
+  }
+
+  // Doubles the buffer, unwrapping the entries to the front of it.
+  void Grow() {
+    std::pmr::vector<FrontierEntry<State>> entries(
+        std::max<std::size_t>(16, 2 * entries_.size()),
+        entries_.get_allocator());
+    for (std::size_t i = 0; i < size_; i++)
+      entries[i] = entries_[(head_ + i) & Mask()];
+    entries_.swap(entries);
+    head_ = 0;
+  }
+
+  // A power of two in size, or empty.
+  std::pmr::vector<FrontierEntry<State>> entries_;
+  std::size_t head_ = 0, size_ = 0;
+};
+
+template <typename State, int kNumBuckets = 32>
+class BucketFrontier {
+ public:
+  static_assert(kNumBuckets > 0 && (kNumBuckets & (kNumBuckets - 1)) == 0,
+                "the number of buckets must be a power of two");
+
+  explicit BucketFrontier(std::pmr::memory_resource* resource =
+                              std::pmr::get_default_resource())
+      : buckets_(kNumBuckets, resource) {}
+
+  bool empty() const { return size_ == 0; }
+  void clear() {
+    for (auto& bucket : buckets_) bucket.clear();
+    size_ = 0;
+  }
+
+  void push(int priority, const State& state) {
+    if (empty()) current_ = priority;
+    assert(current_ <= priority && priority < current_ + kNumBuckets);
+    buckets_[priority & (kNumBuckets - 1)].push_back(state);
+    size_++;
+  }
+
+  FrontierEntry<State> pop() {
+    assert(!empty());
+    while (buckets_[current_ & (kNumBuckets - 1)].empty()) current_++;
+    auto& bucket = buckets_[current_ & (kNumBuckets - 1)];
+    FrontierEntry<State> entry{current_, bucket.back()};
+    bucket.pop_back();
+    size_--;
+    return entry;
+  }
+
+ private:
+  // The bucket for priority p is p % kNumBuckets.
+  std::pmr::vector<std::pmr::vector<State>> buckets_;
+  int current_ = 0;
+  std::size_t size_ = 0;
+};
+
+template <typename State>
+class RadixHeap {
+ public:
+  explicit RadixHeap(std::pmr::memory_resource* resource =
+                         std::pmr::get_default_resource())
+      : buckets_(kNumBuckets, resource) {}
+
+  bool empty() const { return size_ == 0; }
+  void clear() {
+    for (auto& bucket : buckets_) bucket.clear();
+    last_ = 0;
+    size_ = 0;
+  }
+
+  void push(int priority, const State& state) {
+    assert(last_ <= static_cast<unsigned>(priority));
+    buckets_[Bucket(priority)].push_back({priority, state});
+    size_++;
+  }
+
+  FrontierEntry<State> pop() {
+    assert(!empty());
+    if (buckets_[0].empty()) {
+      // Every entry in the first non-empty bucket is spread over lower ones
+      // once its smallest priority becomes the last one taken.
+      std::size_t i = 1;
+      while (buckets_[i].empty()) i++;
+      auto& bucket = buckets_[i];
+      last_ = std::min_element(bucket.begin(), bucket.end(),
+                               [](const auto& a, const auto& b) {
+                                 return a.priority < b.priority;
+                               })
+                  ->priority;
+      for (const auto& entry : bucket)
+        buckets_[Bucket(entry.priority)].push_back(entry);
+      bucket.clear();
+    }
+    FrontierEntry<State> entry = buckets_[0].back();
+    buckets_[0].pop_back();
+    size_--;
+    return entry;
+  }
+
+ private:
+  static constexpr std::size_t kNumBuckets = 33;
+
+  // Bucket 0 holds priorities equal to last_, and bucket i those whose highest
+  // bit that differs from last_ is bit i - 1.
+  std::size_t Bucket(unsigned priority) const {
+    unsigned bits = priority ^ last_;
+    return bits == 0 ? 0 : 32 - __builtin_clz(bits);
+  }
+
+  std::pmr::vector<std::pmr::vector<FrontierEntry<State>>> buckets_;
+  unsigned last_ = 0;
+  std::size_t size_ = 0;
+};
+
+template <typename State>
+class HeapFrontier {
+ public:
+  explicit HeapFrontier(std::pmr::memory_resource* resource =
+                            std::pmr::get_default_resource())
+      : entries_(resource) {}
+
+  bool empty() const { return entries_.empty(); }
+  void clear() { entries_.clear(); }
+
+  void push(int priority, const State& state) {
+    entries_.push_back({priority, state});
+    std::push_heap(entries_.begin(), entries_.end(), Later);
+  }
+
+  FrontierEntry<State> pop() {
+    assert(!empty());
+    std::pop_heap(entries_.begin(), entries_.end(), Later);
+    FrontierEntry<State> entry = entries_.back();
+    entries_.pop_back();
+    return entry;
+  }
+
+ private:
+  static bool Later(const FrontierEntry<State>& a,
+                    const FrontierEntry<State>& b) {
+    return a.priority > b.priority;
+  }
+
+  std::pmr::vector<FrontierEntry<State>> entries_;
+};
+
+// States are numbered from 0 to size - 1 by index(state).
+template <typename Index>
+class DenseVisited {
+ public:
+  DenseVisited(std::size_t size, Index index,
+               std::pmr::memory_resource* resource =
+                   std::pmr::get_default_resource())
+      : index_(std::move(index)), words_((size + 63) / 64, resource) {}
+
+  void clear() { std::fill(words_.begin(), words_.end(), 0); }
+
+  // Returns true if the state had not been visited before.
+  template <typename State>
+  bool insert(const State& state) {
+    const std::size_t i = index_(state);
+    assert(i / 64 < words_.size());
+    const std::uint64_t bit = std::uint64_t{1} << (i % 64);
+    const bool inserted = !(words_[i / 64] & bit);
+    words_[i / 64] |= bit;
+    return inserted;
+  }
+
+  template <typename State>
+  bool contains(const State& state) const {
+    const std::size_t i = index_(state);
+    assert(i / 64 < words_.size());
+    return words_[i / 64] >> (i % 64) & 1;
+  }
+
+ private:
+  Index index_;
+  std::pmr::vector<std::uint64_t> words_;
+};
+
+template <typename State, typename Hash = std::hash<State>>
+class HashedVisited {
+ public:
+  explicit HashedVisited(std::pmr::memory_resource* resource =
+                             std::pmr::get_default_resource())
+      : states_(resource) {}
+
+  // Returns true if the state had not been visited before.
+  bool insert(const State& state) { return states_.insert(state).second; }
+  bool contains(const State& state) const { return states_.count(state); }
+
+ private:
+  FlatHashSet<State, Hash> states_;
+};
+
+// For searches without a heuristic, which are Dijkstra's algorithm, or a
+// breadth-first search if every step costs the same.
+struct NoHeuristic {
+  template <typename State>
+  constexpr int operator()(const State&) const {
+    return 0;
+  }
+};
+
+// Searches from start, calling expand(state, push) for each state that is
+// settled, which calls push(next, step_cost) for each neighbour. Entries are
+// prioritised by their cost plus heuristic(state), so the cost of an entry is
+// recovered from its priority rather than stored alongside it. Returns true if
+// settle() stopped the search, or false if every reachable state was settled.
+template <typename State, typename Frontier, typename Visited,
+          typename Expand, typename Settle, typename Heuristic = NoHeuristic>
+bool Search(const State& start, Frontier& frontier, Visited& visited,
+            Expand expand, Settle settle, Heuristic heuristic = {}) {
+  frontier.push(heuristic(start), start);
+  while (!frontier.empty()) {
+    const auto [priority, state] = frontier.pop();
+    if (!visited.insert(state)) continue;  // Already settled.
+    const int cost = priority - heuristic(state);
+    if (settle(state, cost)) return true;
+    expand(state, [&](const State& next, int step_cost) {
+      frontier.push(cost + step_cost + heuristic(next), next);
+    });
+  }
+  return false;
+}
@@ -0,0 +1,119 @@
+// Line-at-a-time reading of an input which arrives in chunks, for solutions
+// which can run without having the whole input in memory (./solve --stdin):
+//
+// int Solve1A_Stream(LineReader& lines) {
+//   int frequency = 0;
+//   while (auto line = lines.Next()) frequency += Scanner{*line}.Int();
+//   return frequency;
+// }
+// REGISTER_STREAMING_SOLUTION(Solve1A_Stream);
+//
+// The reader has a buffer of a single chunk, and the start of any line which
+// straddles the end of one chunk is kept at the front of the buffer while the
+// next is read, so memory depends on the length of the longest line rather
+// than on the size of the input. Each line is only valid until the next call
+// to Next(). Empty lines are skipped.
+//
+// A reader can also be given an input which is already in memory, which it
+// copies out in chunks in exactly the same way. Streaming solutions are also
+// registered as variants which run like that, so --variants checks them
+// against the main solutions.
+
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+class LineReader {
+ public:
+  static constexpr std::size_t kDefaultChunkSize = 64 << 10;
+
+  explicit LineReader(int fd, std::size_t chunk_size = kDefaultChunkSize)
+      : fd_(fd), chunk_size_(chunk_size) {}
+  explicit LineReader(std::string_view input,
+                      std::size_t chunk_size = kDefaultChunkSize)
+      : input_(input), chunk_size_(chunk_size) {}
+
+  LineReader(const LineReader&) = delete;
+  LineReader& operator=(const LineReader&) = delete;
+
+  // Returns nullopt at the end of the input, or if reading it failed.
+  std::optional<std::string_view> Next() {
+    while (true) {
+      std::string_view unread(buffer_.data() + begin_, end_ - begin_);
+      std::size_t newline = unread.find('\n');
+      if (newline == std::string_view::npos) {
+        if (!done_) {
+          Refill();
+          continue;
+        }
+        // The last line need not end with a newline.
+        if (unread.empty()) return std::nullopt;
+        newline = unread.size();
+      }
+      begin_ += std::min(newline + 1, unread.size());
+      if (newline > 0) return unread.substr(0, newline);
+    }
+  }
+
+  // True if reading stopped because of an error rather than the end of the
+  // input.
+  bool failed() const { return failed_; }
+
+ private:
+  // Moves the unfinished line to the front of the buffer and fills the rest of
+  // it. The buffer only grows if a single line fills all of it.
+  void Refill() {
+    std::size_t partial = end_ - begin_;
+    std::copy(buffer_.begin() + begin_, buffer_.begin() + end_,
+              buffer_.begin());
+    begin_ = 0;
+    end_ = partial;
+    if (partial == buffer_.size())
+      buffer_.resize(std::max(chunk_size_, 2 * partial));
+    std::size_t size = Read(buffer_.data() + end_, buffer_.size() - end_);
+    if (size == 0) done_ = true;
+    end_ += size;
+  }
+
+  std::size_t Read(char* output, std::size_t size) {
+    if (fd_ == -1) {
+      std::size_t copied = input_.copy(output, size);
+      input_.remove_prefix(copied);
+      return copied;
+    }
+    while (true) {
+      ssize_t result = read(fd_, output, size);
+      if (result >= 0) return result;
+      if (errno != EINTR) {
+        failed_ = true;
+        return 0;
+      }
+    }
+  }
+
+  // Either the file descriptor to read, or -1 to read from input_ instead.
+  int fd_ = -1;
+  std::string_view input_;
+  std::size_t chunk_size_;
+  std::vector<char> buffer_;
+  // The unread part of the buffer is [begin_, end_).
+  std::size_t begin_ = 0, end_ = 0;
+  bool done_ = false;
+  bool failed_ = false;
+};
+
+// Runs a streaming solution on an input which is already in memory. The chunks
+// are small enough that lines straddle them in every real input, so that this
+// is exercised whenever the variants are checked.
+template <auto* solve>
+auto SolveInChunks(std::string_view puzzle) {
+  LineReader lines{puzzle, 1 << 10};
+  return solve(lines);
+}
@@ -7,38 +7,91 @@
 // This will output something like:
 //
 // 42 in 25ms
+//
+// Passing a PerfCounters object as well also collects hardware performance
+// counters around the call, which are printed after the time:
+//
+// 42 in 25ms (102M cycles, 250M instructions, 1203K cache misses, ...)
+//
+// For comparing performance, Benchmark() runs a call repeatedly and reports
+// statistics about the distribution of times instead of a single sample:
+//
+// std::cout << Benchmark(CalculateSixTimesNineOptimized, {}) << "\n";
+//
+// 42 in 24ms min, 25ms median, 27ms p90, 31ms p99, 1253us stddev (40 runs)
+//
+// Every run is a real one: the optimiser sees neither what the call depends on
+// nor whether its result is used, so it can't drop the call or hoist it out of
+// the loop. DoNotOptimize() does the same for values in other measurements.
+//
+// Setting BenchmarkOptions::cold evicts the caches and returns freed heap
+// memory to the kernel before every run instead, so that each run starts from
+// cold caches and has to fault in fresh pages.
 
 #pragma once
 
+#include "perf.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif  // __GLIBC__
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <iostream>
+#include <optional>
 #include <thread>
+#include <vector>
+
+// Wrapper for printing a duration with an appropriate unit.
+struct Duration {
+  std::chrono::nanoseconds time;
+};
+
+inline std::ostream& operator<<(std::ostream& output, Duration duration) {
+  using std::literals::operator "" ns;
+  using std::literals::operator "" us;
+  using std::literals::operator "" ms;
+  using std::literals::operator "" s;
+
+  if (duration.time < 10us) {
+    return output << (duration.time / 1ns) << "ns";
+  } else if (duration.time < 10ms) {
+    return output << (duration.time / 1us) << "us";
+  } else if (duration.time < 10s) {
+    return output << (duration.time / 1ms) << "ms";
+  } else {
+    return output << (duration.time / 1s) << "s";
+  }
+}
 
 template <typename T>
 struct TimingResult {
   T value;
   std::chrono::nanoseconds time;
+  std::optional<PerfCounts> counters = std::nullopt;
 };
 template <typename T>
 TimingResult(T, std::chrono::nanoseconds)->TimingResult<T>;
+template <typename T>
+TimingResult(T, std::chrono::nanoseconds, PerfCounts)->TimingResult<T>;
 
 template <typename T>
 std::ostream& operator<<(std::ostream& output, const TimingResult<T>& result) {
-  using std::literals::operator "" ns;
-  using std::literals::operator "" us;
-  using std::literals::operator "" ms;
-  using std::literals::operator "" s;
+  output << result.value << " in " << Duration{result.time};
+  if (result.counters) output << " (" << *result.counters << ")";
+  return output;
+}
 
-  output << result.value << " in ";
-  if (result.time < 10us) {
-    return output << (result.time / 1ns) << "ns";
-  } else if (result.time < 10ms) {
-    return output << (result.time / 1us) << "us";
-  } else if (result.time < 10s) {
-    return output << (result.time / 1ms) << "ms";
-  } else {
-    return output << (result.time / 1s) << "s";
-  }
+// Makes the optimiser assume that value is read and may be modified here, so
+// that the computation of it is kept and can't be moved past this point.
+template <typename T>
+inline void DoNotOptimize(T& value) {
+  asm volatile("" : : "g"(&value) : "memory");
 }
 
 template <typename F>
@@ -48,3 +101,136 @@ auto Time(F&& functor) {
   auto end = std::chrono::steady_clock::now();
   return TimingResult{std::move(result), end - start};
 }
+
+template <typename F>
+auto Time(F&& functor, PerfCounters* counters) {
+  counters->Start();
+  auto start = std::chrono::steady_clock::now();
+  auto result = functor();
+  auto end = std::chrono::steady_clock::now();
+  PerfCounts counts = counters->Stop();
+  return TimingResult{std::move(result), end - start, counts};
+}
+
+struct BenchmarkOptions {
+  // Untimed runs to perform before measuring, to warm up caches.
+  int warmup_runs = 1;
+  // Timed runs stop once either of these limits are reached. At least one timed
+  // run is always performed.
+  std::chrono::nanoseconds time_budget = std::chrono::seconds{1};
+  int max_runs = 1000;
+  // Run with cold caches. There are no warmup runs in this mode.
+  bool cold = false;
+};
+
+// Write to every cache line of a buffer twice the size of the last level
+// cache, which pushes everything else out of every level. The buffer is
+// mapped directly so that it doesn't show up in allocation tracking.
+inline void EvictCaches() {
+  static const std::size_t size = [] {
+    long cache_size = 0;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    cache_size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif  // _SC_LEVEL3_CACHE_SIZE
+    // Assume a large cache if it can't be found.
+    if (cache_size <= 0) cache_size = 64 << 20;
+    return 2 * static_cast<std::size_t>(cache_size);
+  }();
+  static volatile char* const buffer = [] {
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return data == MAP_FAILED ? nullptr : static_cast<volatile char*>(data);
+  }();
+  if (buffer == nullptr) return;
+  constexpr std::size_t kCacheLine = 64;
+  for (std::size_t i = 0; i < size; i += kCacheLine) buffer[i] = buffer[i] + 1;
+}
+
+// Prepare for a run with cold caches. Memory freed by earlier runs is handed
+// back to the kernel where possible, so that it is faulted in again.
+inline void ColdStart() {
+#ifdef __GLIBC__
+  malloc_trim(0);
+#endif  // __GLIBC__
+  EvictCaches();
+}
+
+struct Statistics {
+  std::chrono::nanoseconds min, median, p90, p99, stddev;
+  int runs;
+};
+
+// Summarize a set of samples. The samples are sorted in the process.
+inline Statistics Summarize(std::vector<std::chrono::nanoseconds>& samples) {
+  using std::chrono::nanoseconds;
+  std::sort(samples.begin(), samples.end());
+  const int n = samples.size();
+  auto percentile = [&](int p) { return samples[(n - 1) * p / 100]; };
+  double mean = 0;
+  for (nanoseconds sample : samples) mean += sample.count();
+  mean /= n;
+  double variance = 0;
+  for (nanoseconds sample : samples) {
+    double delta = sample.count() - mean;
+    variance += delta * delta;
+  }
+  variance /= n;
+  auto stddev = nanoseconds{static_cast<nanoseconds::rep>(std::sqrt(variance))};
+  return Statistics{samples.front(), percentile(50), percentile(90),
+                    percentile(99), stddev, n};
+}
+
+template <typename T>
+struct BenchmarkResult {
+  T value;
+  Statistics statistics;
+};
+template <typename T>
+BenchmarkResult(T, Statistics)->BenchmarkResult<T>;
+
+template <typename T>
+std::ostream& operator<<(std::ostream& output,
+                         const BenchmarkResult<T>& result) {
+  const Statistics& s = result.statistics;
+  return output << result.value << " in " << Duration{s.min} << " min, "
+                << Duration{s.median} << " median, " << Duration{s.p90}
+                << " p90, " << Duration{s.p99} << " p99, "
+                << Duration{s.stddev} << " stddev (" << s.runs << " runs)";
+}
+
+template <typename F>
+auto Benchmark(F&& functor, const BenchmarkOptions& options) {
+  // The functor holds the inputs of the call, so hiding it from the optimiser
+  // before each run makes every run depend on inputs which might have changed.
+  auto run = [&functor] {
+    DoNotOptimize(functor);
+    auto result = functor();
+    DoNotOptimize(result);
+    return result;
+  };
+  if (!options.cold) {
+    for (int i = 0; i < options.warmup_runs; i++) run();
+  }
+  // Evicting the caches usually takes longer than the run itself, so cold runs
+  // count it against the time budget too.
+  auto start = std::chrono::steady_clock::now();
+  auto elapsed = [&](std::chrono::nanoseconds time) {
+    if (!options.cold) return time;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+  };
+  std::vector<std::chrono::nanoseconds> samples;
+  std::chrono::nanoseconds total{0};
+  if (options.cold) ColdStart();
+  auto first = Time(run);
+  samples.push_back(first.time);
+  total += first.time;
+  while (elapsed(total) < options.time_budget &&
+         static_cast<int>(samples.size()) < options.max_runs) {
+    if (options.cold) ColdStart();
+    auto time = Time(run).time;
+    samples.push_back(time);
+    total += time;
+  }
+  return BenchmarkResult{std::move(first.value), Summarize(samples)};
+}
@@ -0,0 +1,158 @@
+// Scoped trace spans, for seeing where the time goes inside a solution. A span
+// covers the lifetime of a TraceSpan object:
+//
+// GridData BuildGrid(std::vector<BoundingBox> input) {
+//   TraceSpan span{"BuildGrid"};
+//   ...
+// }
+//
+// Tracing is off unless StartTracing() has been called (./solve --trace=FILE),
+// in which case a span costs a clock read and a store at each end. Otherwise
+// it costs a single load and branch. Each thread records its spans in its own
+// ring buffer, which keeps the most recent kTraceBufferSize of them.
+// WriteTrace() exports everything recorded as Chrome trace event JSON, which
+// can be opened in chrome://tracing or https://ui.perfetto.dev, and
+// StopTracing() frees the buffers again.
+//
+// Span names must outlive the trace, so they should be string literals.
+//
+// The fast runtime has no tracing, and spans compile to nothing there.
+
+#pragma once
+
+#ifdef FAST_RUNTIME
+
+class TraceSpan {
+ public:
+  explicit constexpr TraceSpan(const char*) {}
+};
+
+#else  // FAST_RUNTIME
+
+#include "allocation.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <ios>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+constexpr std::size_t kTraceBufferSize = 1 << 16;
+
+namespace trace_internal {
+
+struct Event {
+  std::string_view name;
+  std::chrono::steady_clock::time_point start, end;
+};
+
+struct Buffer {
+  int thread_id;
+  // Total number of events recorded. Only the last kTraceBufferSize of them
+  // are still in the buffer.
+  std::size_t count = 0;
+  Event events[kTraceBufferSize];
+};
+
+inline std::atomic<bool> enabled = false;
+inline std::chrono::steady_clock::time_point epoch;
+
+// Every buffer created since tracing started. They are kept until tracing
+// stops so that the spans of threads which have already exited can still be
+// written.
+inline std::mutex buffers_mutex;
+inline std::vector<std::unique_ptr<Buffer>> buffers;
+inline thread_local Buffer* thread_buffer = nullptr;
+
+inline Buffer& ThreadBuffer() {
+  if (thread_buffer == nullptr) {
+    // The buffer belongs to the trace, not to whichever solution happened to
+    // record the first span on this thread.
+    UntrackedAllocations untracked;
+    std::lock_guard lock{buffers_mutex};
+    auto& added = buffers.emplace_back(std::make_unique<Buffer>());
+    added->thread_id = buffers.size();
+    thread_buffer = added.get();
+  }
+  return *thread_buffer;
+}
+
+}  // namespace trace_internal
+
+class TraceSpan {
+ public:
+  explicit TraceSpan(std::string_view name) : name_(name) {
+    if (trace_internal::enabled.load(std::memory_order_relaxed)) {
+      // Creating the buffer is slow, so it happens before the span starts.
+      buffer_ = &trace_internal::ThreadBuffer();
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~TraceSpan() {
+    if (buffer_ == nullptr) return;
+    auto end = std::chrono::steady_clock::now();
+    buffer_->events[buffer_->count++ % kTraceBufferSize] = {name_, start_, end};
+  }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+ private:
+  std::string_view name_;
+  trace_internal::Buffer* buffer_ = nullptr;
+  std::chrono::steady_clock::time_point start_;
+};
+
+inline void StartTracing() {
+  trace_internal::epoch = std::chrono::steady_clock::now();
+  trace_internal::enabled = true;
+}
+
+// Writes every recorded span. This must only be called once the threads which
+// recorded them have finished. Times are in microseconds with nanosecond
+// precision.
+inline void WriteTrace(std::ostream& output) {
+  using namespace trace_internal;
+  auto microseconds = [](std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  };
+  std::lock_guard lock{buffers_mutex};
+  std::ios::fmtflags flags = output.flags();
+  std::streamsize precision = output.precision();
+  output << std::fixed << std::setprecision(3) << "{\"traceEvents\": [";
+  bool first = true;
+  for (const auto& buffer : buffers) {
+    std::size_t begin =
+        buffer->count > kTraceBufferSize ? buffer->count - kTraceBufferSize : 0;
+    for (std::size_t i = begin; i < buffer->count; i++) {
+      const Event& event = buffer->events[i % kTraceBufferSize];
+      // Span names are identifiers, so they never need escaping.
+      output << (first ? "\n" : ",\n") << "{\"name\": \"" << event.name
+             << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->thread_id
+             << ", \"ts\": " << microseconds(event.start - epoch)
+             << ", \"dur\": " << microseconds(event.end - event.start) << "}";
+      first = false;
+    }
+  }
+  output << "\n]}\n";
+  output.flags(flags);
+  output.precision(precision);
+}
+
+// Discards everything recorded. Like WriteTrace(), this must only be called
+// once every other thread which recorded spans has finished.
+inline void StopTracing() {
+  using namespace trace_internal;
+  enabled = false;
+  std::lock_guard lock{buffers_mutex};
+  std::vector<std::unique_ptr<Buffer>>().swap(buffers);
+  thread_buffer = nullptr;
+}
+
+#endif  // FAST_RUNTIME
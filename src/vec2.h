@@ -1,5 +1,11 @@
 #pragma once
 
+#include "hash.h"
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
 template <typename T>
 struct vec2 {
   constexpr vec2() = default;
@@ -67,9 +73,11 @@ constexpr bool operator<=(vec2<T> a, vec2<T> b) { return !(b < a); }
 template <typename T>
 constexpr bool operator>=(vec2<T> a, vec2<T> b) { return !(a < b); }
 
+// Grid coordinates are small and clustered, so they are mixed rather than
+// simply combined.
 template <typename T>
 struct std::hash<vec2<T>> {
-  constexpr auto operator()(vec2<T> v) const {
-    return (v.x * 19) ^ (v.y * 37);
+  constexpr std::size_t operator()(vec2<T> v) const {
+    return HashMix(HashPack(v.x, v.y));
   }
 };